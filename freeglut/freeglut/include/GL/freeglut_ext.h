@@ -92,6 +92,23 @@
 
 #define  GLUT_ALLOW_NEGATIVE_WINDOW_POSITION 0x0207 /* GLUT doesn't allow negative window positions by default */
 
+#define  GLUT_SHAPE_CACHE_MEMORY            0x0208  /* Max. bytes of tessellated spheres, cones, cylinders and tori to keep */
+#define  GLUT_SHAPE_CACHE_HITS              0x0209
+#define  GLUT_SHAPE_CACHE_MISSES            0x020A
+
+#define  GLUT_ELAPSED_TIME_US               0x020B  /* glutGet(GLUT_ELAPSED_TIME) in microseconds */
+
+#define  GLUT_BITMAP_FONT_ATLAS             0x020C  /* Draw bitmap fonts as textured quads instead of with glBitmap? */
+
+#define  GLUT_BATCHED_REDRAW                0x020D  /* Redraw windows grouped by OpenGL context instead of in request order? */
+
+#define  GLUT_COALESCE_EVENTS               0x020E  /* Read all pending events at once and drop those superseded by later ones (X11 only)? */
+
+#define  GLUT_TEASET_SOLID_SUBDIVISIONS     0x020F  /* Vertices along each side of the patches of the solid teapot, teacup and teaspoon */
+#define  GLUT_TEASET_WIRE_SUBDIVISIONS      0x0210  /* Same for the wire versions */
+
+#define  GLUT_AUTHORITATIVE_GEOMETRY        0x0211  /* Ask the window system for the window position, size and borders on every glutGet instead of answering from events (X11 only)? */
+
 #define  GLUT_WINDOW_SRGB                   0x007D
 
 /*
@@ -145,6 +162,20 @@ FGAPI void    FGAPIENTRY glutMainLoopEvent( void );
 FGAPI void    FGAPIENTRY glutLeaveMainLoop( void );
 FGAPI void    FGAPIENTRY glutExit         ( void );
 
+/*
+ * Running the main loop from the application's own event loop, see fg_main.c
+ */
+FGAPI int     FGAPIENTRY glutGetEventFds( int* fds, int* events, int maxFds );
+FGAPI int     FGAPIENTRY glutGetNextTimeout( void );
+FGAPI int     FGAPIENTRY glutDispatchReady( void );
+
+/*
+ * Main loop functions that other threads may call, see fg_main.c
+ */
+FGAPI void    FGAPIENTRY glutWakeMainLoop( void );
+FGAPI void    FGAPIENTRY glutRunOnMainLoop( void (* callback)( void* ), void* userData );
+FGAPI void    FGAPIENTRY glutPostWindowRedisplayAsync( int window );
+
 /*
  * Window management functions, see fg_window.c
  */
@@ -166,6 +197,24 @@ FGAPI void    FGAPIENTRY glutWMCloseFunc( void (* callback)( void ) );
 /* And also a destruction callback for menus */
 FGAPI void    FGAPIENTRY glutMenuDestroyFunc( void (* callback)( void ) );
 
+/* glutTimerFunc with the time out given in microseconds */
+FGAPI void    FGAPIENTRY glutTimerFuncUs( unsigned int usecs, void (* callback)( int ), int value );
+
+/* Removes the pending timers registered with the given value */
+FGAPI void    FGAPIENTRY glutCancelTimer( int value );
+
+/*
+ * Have the main loop wait on the application's own descriptors as well,
+ * and call back with the GLUT_INPUT_* events that are ready. Remove a
+ * descriptor before closing it. Not supported on Windows.
+ */
+#define  GLUT_INPUT_READABLE                0x0001
+#define  GLUT_INPUT_WRITABLE                0x0002
+#define  GLUT_INPUT_ERROR                   0x0004
+
+FGAPI void    FGAPIENTRY glutAddInputFd( int fd, int events, void (* callback)( int, int ) );
+FGAPI void    FGAPIENTRY glutRemoveInputFd( int fd );
+
 /*
  * State setting and retrieval functions, see fg_state.c
  */
@@ -184,6 +233,7 @@ FGAPI int     FGAPIENTRY glutBitmapHeight( void* font );
 FGAPI GLfloat FGAPIENTRY glutStrokeHeight( void* font );
 FGAPI void    FGAPIENTRY glutBitmapString( void* font, const unsigned char *string );
 FGAPI void    FGAPIENTRY glutStrokeString( void* font, const unsigned char *string );
+FGAPI void    FGAPIENTRY glutResetStrokePen( void );
 
 /*
  * Geometry functions, see fg_geometry.c
@@ -195,6 +245,24 @@ FGAPI void    FGAPIENTRY glutSolidSierpinskiSponge ( int num_levels, double offs
 FGAPI void    FGAPIENTRY glutWireCylinder( double radius, double height, GLint slices, GLint stacks);
 FGAPI void    FGAPIENTRY glutSolidCylinder( double radius, double height, GLint slices, GLint stacks);
 
+/*
+ * Instanced geometry, see fg_geometry.c: draw count copies of a shape,
+ * each transformed by a column-major 4x4 matrix (16 floats per copy in
+ * transforms) and optionally colored (4 floats per copy in colors, may be
+ * NULL). With OpenGL >= 2.0 attributes, the matrix and color are passed
+ * to the attributes set with glutSetVertexAttribInstanceMatrix/Color.
+ */
+FGAPI void    FGAPIENTRY glutWireCubeInstanced( double size, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutSolidCubeInstanced( double size, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutWireSphereInstanced( double radius, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutSolidSphereInstanced( double radius, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutWireConeInstanced( double base, double height, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutSolidConeInstanced( double base, double height, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutWireCylinderInstanced( double radius, double height, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutSolidCylinderInstanced( double radius, double height, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutWireTorusInstanced( double innerRadius, double outerRadius, GLint sides, GLint rings, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+FGAPI void    FGAPIENTRY glutSolidTorusInstanced( double innerRadius, double outerRadius, GLint sides, GLint rings, GLsizei count, const GLfloat *transforms, const GLfloat *colors );
+
 /*
  * Rest of functions for rendering Newell's teaset, found in fg_teapot.c
  * NB: front facing polygons have clockwise winding, not counter clockwise
@@ -209,6 +277,7 @@ FGAPI void    FGAPIENTRY glutSolidTeaspoon( double size );
  */
 typedef void (*GLUTproc)();
 FGAPI GLUTproc FGAPIENTRY glutGetProcAddress( const char *procName );
+FGAPI int     FGAPIENTRY glutGetProcAddresses( const char **procNames, GLUTproc *procs, int count );
 
 /*
  * Multi-touch/multi-pointer extensions
@@ -261,6 +330,8 @@ FGAPI void    FGAPIENTRY glutInitWarningFunc( void (* callback)( const char *fmt
 FGAPI void    FGAPIENTRY glutSetVertexAttribCoord3( GLint attrib );
 FGAPI void    FGAPIENTRY glutSetVertexAttribNormal( GLint attrib );
 FGAPI void    FGAPIENTRY glutSetVertexAttribTexCoord2( GLint attrib );
+FGAPI void    FGAPIENTRY glutSetVertexAttribInstanceMatrix( GLint attrib ); /* uses attrib to attrib+3 */
+FGAPI void    FGAPIENTRY glutSetVertexAttribInstanceColor( GLint attrib );
 
 /* Mobile platforms lifecycle */
 FGAPI void    FGAPIENTRY glutInitContextFunc( void (* callback)( void ) );
@@ -27,6 +27,8 @@ FGAPI int  FGAPIENTRY glutCreateMenuUcall( void (* callback)( int menu, void* us
  * Global callback functions, see fg_callbacks.c
  */
 FGAPI void FGAPIENTRY glutTimerFuncUcall( unsigned int time, void (* callback)( int, void* ), int value, void* user_data );
+FGAPI void FGAPIENTRY glutTimerFuncUsUcall( unsigned int usecs, void (* callback)( int, void* ), int value, void* user_data );
+FGAPI void FGAPIENTRY glutAddInputFdUcall( int fd, int events, void (* callback)( int, int, void* ), void* user_data );
 FGAPI void FGAPIENTRY glutIdleFuncUcall( void (* callback)( void* ), void* user_data );
 
 /*
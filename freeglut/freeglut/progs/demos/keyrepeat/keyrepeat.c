@@ -0,0 +1,198 @@
+/* Key repeat replay
+ *
+ * Feeds made up X11 key event sequences through freeglut's auto repeat
+ * check, the way the main loop does with glutIgnoreKeyRepeat(1), and
+ * checks which key presses and releases reach the application. Then times
+ * the check on a long stream of a held key. No display is needed.
+ *
+ * Exits with 1 if a sequence is handled wrongly.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <X11/Xlib.h>
+#include <GL/freeglut.h>
+
+/* src/x11/fg_keyrepeat_x11.c */
+extern GLboolean fgPlatformIsKeyRepeat(const XKeyEvent *release, const XEvent *next);
+
+#define KEY_A   38
+#define KEY_B   56
+#define WIN_1   1
+#define WIN_2   2
+
+#define MAX_EVENTS  16
+#define BENCH_EVENTS    (1 << 20)
+#define BENCH_PASSES    20
+
+struct key_event {
+	int type;
+	Window win;
+	unsigned int keycode;
+	Time time;
+};
+
+struct sequence {
+	const char *name;
+	struct key_event ev[MAX_EVENTS];
+	int delivered_presses, delivered_releases;
+};
+
+/* event lists end with a zero type */
+static const struct sequence sequences[] = {
+	{"single tap",
+		{{KeyPress, WIN_1, KEY_A, 100}, {KeyRelease, WIN_1, KEY_A, 180}},
+		1, 1},
+	{"held key",
+		{{KeyPress, WIN_1, KEY_A, 100},
+		 {KeyRelease, WIN_1, KEY_A, 600}, {KeyPress, WIN_1, KEY_A, 600},
+		 {KeyRelease, WIN_1, KEY_A, 633}, {KeyPress, WIN_1, KEY_A, 633},
+		 {KeyRelease, WIN_1, KEY_A, 667}, {KeyPress, WIN_1, KEY_A, 667},
+		 {KeyRelease, WIN_1, KEY_A, 690}},
+		1, 1},
+	{"repeat a millisecond apart",
+		{{KeyPress, WIN_1, KEY_A, 100},
+		 {KeyRelease, WIN_1, KEY_A, 600}, {KeyPress, WIN_1, KEY_A, 601},
+		 {KeyRelease, WIN_1, KEY_A, 700}},
+		1, 1},
+	{"fast retype",
+		{{KeyPress, WIN_1, KEY_A, 100}, {KeyRelease, WIN_1, KEY_A, 150},
+		 {KeyPress, WIN_1, KEY_A, 170}, {KeyRelease, WIN_1, KEY_A, 220}},
+		2, 2},
+	{"other key pressed on release",
+		{{KeyPress, WIN_1, KEY_A, 100}, {KeyRelease, WIN_1, KEY_A, 150},
+		 {KeyPress, WIN_1, KEY_B, 150}, {KeyRelease, WIN_1, KEY_B, 200}},
+		2, 2},
+	{"same key in another window",
+		{{KeyPress, WIN_1, KEY_A, 100}, {KeyRelease, WIN_1, KEY_A, 150},
+		 {KeyPress, WIN_2, KEY_A, 150}, {KeyRelease, WIN_2, KEY_A, 200}},
+		2, 2},
+	{"release followed by motion",
+		{{KeyPress, WIN_1, KEY_A, 100}, {KeyRelease, WIN_1, KEY_A, 150},
+		 {MotionNotify, WIN_1, 0, 150}},
+		1, 1},
+	{"held key across timestamp wrap",
+		{{KeyPress, WIN_1, KEY_A, 0xfffffff0UL},
+		 {KeyRelease, WIN_1, KEY_A, 0xffffffffUL}, {KeyPress, WIN_1, KEY_A, 0},
+		 {KeyRelease, WIN_1, KEY_A, 40}},
+		1, 1}
+};
+
+static void make_events(const struct key_event *kev, int n, XEvent *ev)
+{
+	int i;
+
+	for(i=0; i<n; i++) {
+		ev[i].type = kev[i].type;
+		ev[i].xkey.type = kev[i].type;
+		ev[i].xkey.window = kev[i].win;
+		ev[i].xkey.keycode = kev[i].keycode;
+		ev[i].xkey.time = kev[i].time;
+	}
+}
+
+/* Follows fgPlatformProcessSingleEvent's handling of KeyPress/KeyRelease,
+ * with one repeat state per window, and counts what it would deliver.
+ */
+static void replay(const XEvent *ev, int n, int *presses, int *releases)
+{
+	GLboolean repeating[3] = {GL_FALSE, GL_FALSE, GL_FALSE};
+	int i;
+
+	*presses = *releases = 0;
+	for(i=0; i<n; i++) {
+		GLboolean *rep;
+
+		if(ev[i].type != KeyPress && ev[i].type != KeyRelease) {
+			continue;
+		}
+		rep = &repeating[ev[i].xkey.window];
+
+		if(ev[i].type == KeyRelease) {
+			*rep = fgPlatformIsKeyRepeat(&ev[i].xkey, i + 1 < n ? &ev[i + 1] : NULL);
+		}
+		if(*rep) {
+			if(ev[i].type == KeyPress) *rep = GL_FALSE;
+			continue;
+		}
+		if(ev[i].type == KeyPress) {
+			(*presses)++;
+		} else {
+			(*releases)++;
+		}
+	}
+}
+
+static int check_sequences(void)
+{
+	XEvent ev[MAX_EVENTS];
+	int i, n, presses, releases, failed = 0;
+
+	for(i=0; i<(int)(sizeof sequences / sizeof *sequences); i++) {
+		const struct sequence *seq = sequences + i;
+
+		for(n=0; n<MAX_EVENTS && seq->ev[n].type; n++);
+		make_events(seq->ev, n, ev);
+		replay(ev, n, &presses, &releases);
+
+		if(presses != seq->delivered_presses || releases != seq->delivered_releases) {
+			printf("FAIL %-32s %d presses, %d releases, expected %d, %d\n", seq->name,
+					presses, releases, seq->delivered_presses, seq->delivered_releases);
+			failed = 1;
+		} else {
+			printf("ok   %s\n", seq->name);
+		}
+	}
+	return failed;
+}
+
+static double now(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static int benchmark(void)
+{
+	XEvent *ev;
+	double start, t;
+	int i, presses, releases;
+
+	if(!(ev = malloc(BENCH_EVENTS * sizeof *ev))) {
+		fprintf(stderr, "failed to allocate %d events\n", BENCH_EVENTS);
+		return 1;
+	}
+
+	/* a key held down for the whole stream, repeating every 33ms */
+	ev[0].type = KeyPress;
+	ev[0].xkey.time = 0;
+	for(i=1; i<BENCH_EVENTS; i++) {
+		ev[i].type = i & 1 ? KeyRelease : KeyPress;
+		ev[i].xkey.time = ((i + 1) / 2) * 33;
+	}
+	for(i=0; i<BENCH_EVENTS; i++) {
+		ev[i].xkey.type = ev[i].type;
+		ev[i].xkey.window = WIN_1;
+		ev[i].xkey.keycode = KEY_A;
+	}
+
+	start = now();
+	for(i=0; i<BENCH_PASSES; i++) {
+		replay(ev, BENCH_EVENTS, &presses, &releases);
+	}
+	t = now() - start;
+	free(ev);
+
+	printf("%d events x %d passes: %.3f s, %.1f million events/s (%d presses, %d releases)\n",
+			BENCH_EVENTS, BENCH_PASSES, t, BENCH_EVENTS * (double)BENCH_PASSES / t / 1e6,
+			presses, releases);
+	return presses != 1 || releases != 1;
+}
+
+int main(void)
+{
+	int failed = check_sequences();
+	failed |= benchmark();
+	return failed;
+}
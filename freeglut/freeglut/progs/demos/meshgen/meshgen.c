@@ -0,0 +1,214 @@
+/* Mesh generation kernels
+ *
+ * Runs the inner loops generating the vertices and normals of the sphere,
+ * cone, cylinder and torus (src/fg_geometry_kernels.c) both with the SIMD
+ * kernels the library uses and with their scalar versions. Checks that
+ * their output is bit for bit the same, then times both and prints
+ * vertices per second for each shape. No window is opened.
+ *
+ * Usage: meshgen [subdivisions]    (default 256, for 256x256 meshes)
+ *
+ * Exits with 1 if the SIMD and scalar output differ.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <GL/freeglut.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* src/fg_geometry_kernels.c */
+void fgGeometryRing(GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+		GLfloat r, GLfloat z, GLfloat nScale, GLfloat nz);
+void fgGeometryRingScalar(GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+		GLfloat r, GLfloat z, GLfloat nScale, GLfloat nz);
+void fgGeometrySphereRow(GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+		GLfloat s, GLfloat z, GLfloat radius);
+void fgGeometrySphereRowScalar(GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+		GLfloat s, GLfloat z, GLfloat radius);
+void fgGeometryTorusRing(GLfloat *vert, GLfloat *norm, const GLfloat *cphi, const GLfloat *sphi, int n,
+		GLfloat cp, GLfloat sp, GLfloat iradius, GLfloat oradius);
+void fgGeometryTorusRingScalar(GLfloat *vert, GLfloat *norm, const GLfloat *cphi, const GLfloat *sphi, int n,
+		GLfloat cp, GLfloat sp, GLfloat iradius, GLfloat oradius);
+const char *fgGeometryKernelsISA(void);
+
+enum { SPHERE, CONE, CYLINDER, TORUS, NUM_SHAPES };
+const char *shape_names[NUM_SHAPES] = {"sphere", "cone", "cylinder", "torus"};
+
+/* how long each shape is timed for, with each version */
+#define BENCH_SECONDS	0.5
+
+/* circle tables as fghCircleTable makes them, |n|+1 entries, the sign of
+ * n giving the direction
+ */
+static void circle_table(GLfloat *sint, GLfloat *cost, int n, int half_circle)
+{
+	const GLfloat angle = (half_circle ? 1 : 2) * (GLfloat)M_PI / (GLfloat)n;
+	const int size = abs(n);
+	int i;
+
+	sint[0] = 0.0f;
+	cost[0] = 1.0f;
+	for(i=1; i<size; i++) {
+		sint[i] = (GLfloat)sin(angle * i);
+		cost[i] = (GLfloat)cos(angle * i);
+	}
+	sint[size] = half_circle ? 0.0f : sint[0];
+	cost[size] = half_circle ? -1.0f : cost[0];
+}
+
+/* Generates the sides of an n x n shape the way fg_geometry.c does, with
+ * the SIMD or the scalar kernels. Returns the number of vertices.
+ */
+static int generate(int shape, int n, int simd, GLfloat *vert, GLfloat *norm,
+		const GLfloat *sin1, const GLfloat *cos1, const GLfloat *sin2, const GLfloat *cos2)
+{
+	int i;
+
+	switch(shape) {
+	case SPHERE:
+		for(i=1; i<n; i++) {
+			GLfloat *v = vert + 3 * (i - 1) * n, *nv = norm + 3 * (i - 1) * n;
+			if(simd) {
+				fgGeometrySphereRow(v, nv, cos1, sin1, n, sin2[i], cos2[i], 1.5f);
+			} else {
+				fgGeometrySphereRowScalar(v, nv, cos1, sin1, n, sin2[i], cos2[i], 1.5f);
+			}
+		}
+		return (n - 1) * n;
+
+	case CONE:
+	case CYLINDER:
+		{
+			GLfloat z = 0.0f, r = 1.0f;
+			const GLfloat step = 1.0f / n;
+			const GLfloat cosn = (GLfloat)(2.0 / sqrt(5.0)), sinn = (GLfloat)(1.0 / sqrt(5.0));
+
+			for(i=0; i<=n; i++) {
+				GLfloat *v = vert + 3 * i * n, *nv = norm + 3 * i * n;
+				GLfloat scale = shape == CONE ? cosn : 1.0f, nz = shape == CONE ? sinn : 0.0f;
+				if(simd) {
+					fgGeometryRing(v, nv, cos1, sin1, n, r, z, scale, nz);
+				} else {
+					fgGeometryRingScalar(v, nv, cos1, sin1, n, r, z, scale, nz);
+				}
+				z += 2.0f * step;
+				if(shape == CONE) r -= step;
+			}
+		}
+		return (n + 1) * n;
+
+	case TORUS:
+		for(i=0; i<n; i++) {
+			GLfloat *v = vert + 3 * i * n, *nv = norm + 3 * i * n;
+			if(simd) {
+				fgGeometryTorusRing(v, nv, cos1, sin1, n, cos2[i], sin2[i], 0.3f, 1.0f);
+			} else {
+				fgGeometryTorusRingScalar(v, nv, cos1, sin1, n, cos2[i], sin2[i], 0.3f, 1.0f);
+			}
+		}
+		return n * n;
+	}
+	return 0;
+}
+
+static double seconds(clock_t c)
+{
+	return (double)c / CLOCKS_PER_SEC;
+}
+
+/* vertices per second, generating the shape over and over */
+static double bench(int shape, int n, int simd, GLfloat *vert, GLfloat *norm,
+		const GLfloat *sin1, const GLfloat *cos1, const GLfloat *sin2, const GLfloat *cos2)
+{
+	clock_t start = clock();
+	double verts = 0.0, t;
+
+	do {
+		verts += generate(shape, n, simd, vert, norm, sin1, cos1, sin2, cos2);
+	} while((t = seconds(clock() - start)) < BENCH_SECONDS);
+
+	return verts / t;
+}
+
+int main(int argc, char **argv)
+{
+	/* sizes with and without a partial last group of 4 */
+	static const int check_sizes[] = {1, 2, 3, 4, 5, 7, 16, 33, 255};
+	int subdiv = argc > 1 ? atoi(argv[1]) : 256;
+	int max_n, num_verts, shape, i, failed = 0;
+	GLfloat *sin1, *cos1, *sin2, *cos2, *vert[2], *norm[2];
+
+	if(subdiv < 2) {
+		fprintf(stderr, "usage: %s [subdivisions, at least 2]\n", argv[0]);
+		return 1;
+	}
+	max_n = subdiv > 255 ? subdiv : 255;
+	num_verts = (max_n + 1) * max_n;
+
+	sin1 = malloc((max_n + 1) * sizeof *sin1);
+	cos1 = malloc((max_n + 1) * sizeof *cos1);
+	sin2 = malloc((max_n + 1) * sizeof *sin2);
+	cos2 = malloc((max_n + 1) * sizeof *cos2);
+	for(i=0; i<2; i++) {
+		vert[i] = malloc(num_verts * 3 * sizeof(GLfloat));
+		norm[i] = malloc(num_verts * 3 * sizeof(GLfloat));
+	}
+	if(!sin1 || !cos1 || !sin2 || !cos2 || !vert[0] || !norm[0] || !vert[1] || !norm[1]) {
+		fprintf(stderr, "failed to allocate %d vertices\n", num_verts);
+		return 1;
+	}
+
+	printf("kernels: %s\n", fgGeometryKernelsISA());
+
+	for(shape=0; shape<NUM_SHAPES; shape++) {
+		for(i=0; i<(int)(sizeof check_sizes / sizeof *check_sizes) + 1; i++) {
+			int n = i < (int)(sizeof check_sizes / sizeof *check_sizes) ? check_sizes[i] : subdiv;
+			int nv;
+
+			circle_table(sin1, cos1, -n, 0);
+			circle_table(sin2, cos2, n, shape == SPHERE);
+			memset(vert[0], 0xff, num_verts * 3 * sizeof(GLfloat));
+			memset(norm[0], 0xff, num_verts * 3 * sizeof(GLfloat));
+
+			nv = generate(shape, n, 1, vert[0], norm[0], sin1, cos1, sin2, cos2);
+			generate(shape, n, 0, vert[1], norm[1], sin1, cos1, sin2, cos2);
+
+			if(memcmp(vert[0], vert[1], nv * 3 * sizeof(GLfloat)) ||
+					memcmp(norm[0], norm[1], nv * 3 * sizeof(GLfloat))) {
+				printf("FAIL %s %dx%d: SIMD and scalar output differ\n", shape_names[shape], n, n);
+				failed = 1;
+			}
+		}
+	}
+	if(!failed) {
+		printf("SIMD and scalar output identical for all shapes\n");
+	}
+
+	printf("%dx%d subdivisions, million vertices/s:\n", subdiv, subdiv);
+	printf("%-10s %10s %10s %8s\n", "shape", "scalar", "SIMD", "speedup");
+	circle_table(sin1, cos1, -subdiv, 0);
+	for(shape=0; shape<NUM_SHAPES; shape++) {
+		double scalar, simd;
+
+		circle_table(sin2, cos2, subdiv, shape == SPHERE);
+		scalar = bench(shape, subdiv, 0, vert[1], norm[1], sin1, cos1, sin2, cos2);
+		simd = bench(shape, subdiv, 1, vert[0], norm[0], sin1, cos1, sin2, cos2);
+		printf("%-10s %10.1f %10.1f %7.2fx\n", shape_names[shape], scalar / 1e6, simd / 1e6,
+				simd / scalar);
+	}
+
+	free(sin1);
+	free(cos1);
+	free(sin2);
+	free(cos2);
+	for(i=0; i<2; i++) {
+		free(vert[i]);
+		free(norm[i]);
+	}
+	return failed;
+}
@@ -0,0 +1,376 @@
+/*! \file    vertexlayout.c
+    \ingroup demos
+
+    Times drawing a mesh from separate coordinate, normal and texture
+    coordinate buffers against drawing it from one buffer interleaving
+    them per vertex, the layout freeglut's OpenGL 2.0 shape drawing
+    uploads (see fghUploadGeometry20 in src/fg_geometry.c).
+
+    The mesh is a sphere of about 130000 vertices, drawn many times per
+    frame into a small window so that vertex fetching, rather than
+    filling, is what gets timed. The layouts take turns; after each run
+    the average time per frame is printed to stdout.
+
+   Keys:
+      -    <tt>Esc &nbsp;</tt> Quit
+      -    <tt>q Q &nbsp;</tt> Quit
+      -    <tt>= + &nbsp;</tt> Draw the mesh more often per frame
+      -    <tt>- _ &nbsp;</tt> Draw the mesh less often per frame
+*/
+
+#include <GL/freeglut.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * Function and macro definitions for buffer objects and shaders, avoiding
+ * a dependency on additional libraries like GLEW or the GL/glext.h header
+ */
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#endif
+
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER 0x8B31
+#endif
+
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+
+typedef ptrdiff_t ourGLsizeiptr;
+typedef char ourGLchar;
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+typedef void (APIENTRY *ourGenBuffers) (GLsizei n, GLuint *buffers);
+typedef void (APIENTRY *ourBindBuffer) (GLenum target, GLuint buffer);
+typedef void (APIENTRY *ourBufferData) (GLenum target, ourGLsizeiptr size, const GLvoid *data, GLenum usage);
+typedef void (APIENTRY *ourVertexAttribPointer) (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *pointer);
+typedef void (APIENTRY *ourEnableVertexAttribArray) (GLuint index);
+typedef GLuint (APIENTRY *ourCreateShader) (GLenum type);
+typedef void (APIENTRY *ourShaderSource) (GLuint shader, GLsizei count, const ourGLchar **string, const GLint *length);
+typedef void (APIENTRY *ourCompileShader) (GLuint shader);
+typedef GLuint (APIENTRY *ourCreateProgram) (void);
+typedef void (APIENTRY *ourAttachShader) (GLuint program, GLuint shader);
+typedef void (APIENTRY *ourBindAttribLocation) (GLuint program, GLuint index, const ourGLchar *name);
+typedef void (APIENTRY *ourLinkProgram) (GLuint program);
+typedef void (APIENTRY *ourGetProgramiv) (GLuint program, GLenum pname, GLint *params);
+typedef void (APIENTRY *ourUseProgram) (GLuint program);
+
+ourGenBuffers gl_GenBuffers;
+ourBindBuffer gl_BindBuffer;
+ourBufferData gl_BufferData;
+ourVertexAttribPointer gl_VertexAttribPointer;
+ourEnableVertexAttribArray gl_EnableVertexAttribArray;
+ourCreateShader gl_CreateShader;
+ourShaderSource gl_ShaderSource;
+ourCompileShader gl_CompileShader;
+ourCreateProgram gl_CreateProgram;
+ourAttachShader gl_AttachShader;
+ourBindAttribLocation gl_BindAttribLocation;
+ourLinkProgram gl_LinkProgram;
+ourGetProgramiv gl_GetProgramiv;
+ourUseProgram gl_UseProgram;
+
+int initFunctions(void)
+{
+    gl_GenBuffers = (ourGenBuffers) glutGetProcAddress ("glGenBuffers");
+    gl_BindBuffer = (ourBindBuffer) glutGetProcAddress ("glBindBuffer");
+    gl_BufferData = (ourBufferData) glutGetProcAddress ("glBufferData");
+    gl_VertexAttribPointer = (ourVertexAttribPointer) glutGetProcAddress ("glVertexAttribPointer");
+    gl_EnableVertexAttribArray = (ourEnableVertexAttribArray) glutGetProcAddress ("glEnableVertexAttribArray");
+    gl_CreateShader = (ourCreateShader) glutGetProcAddress ("glCreateShader");
+    gl_ShaderSource = (ourShaderSource) glutGetProcAddress ("glShaderSource");
+    gl_CompileShader = (ourCompileShader) glutGetProcAddress ("glCompileShader");
+    gl_CreateProgram = (ourCreateProgram) glutGetProcAddress ("glCreateProgram");
+    gl_AttachShader = (ourAttachShader) glutGetProcAddress ("glAttachShader");
+    gl_BindAttribLocation = (ourBindAttribLocation) glutGetProcAddress ("glBindAttribLocation");
+    gl_LinkProgram = (ourLinkProgram) glutGetProcAddress ("glLinkProgram");
+    gl_GetProgramiv = (ourGetProgramiv) glutGetProcAddress ("glGetProgramiv");
+    gl_UseProgram = (ourUseProgram) glutGetProcAddress ("glUseProgram");
+
+    return gl_GenBuffers && gl_BindBuffer && gl_BufferData && gl_VertexAttribPointer &&
+           gl_EnableVertexAttribArray && gl_CreateShader && gl_ShaderSource &&
+           gl_CompileShader && gl_CreateProgram && gl_AttachShader &&
+           gl_BindAttribLocation && gl_LinkProgram && gl_GetProgramiv && gl_UseProgram;
+}
+
+/* the attributes are bound to fixed locations before linking */
+#define ATTRIB_COORD    0
+#define ATTRIB_NORMAL   1
+#define ATTRIB_TEXTURE  2
+
+const ourGLchar *vertexShaderSource[] = {
+    "attribute vec3 fg_coord;",
+    "attribute vec3 fg_normal;",
+    "attribute vec2 fg_texture;",
+    "varying vec4 color;",
+    "void main()",
+    "{",
+    "    float light = max(dot(fg_normal, vec3(0.0, 0.0, 1.0)), 0.2);",
+    "    color = vec4(light * vec3(fg_texture, 1.0), 1.0);",
+    "    gl_Position = vec4(0.9 * fg_coord, 1.0);",
+    "}"
+};
+
+const ourGLchar *fragmentShaderSource[] = {
+    "varying vec4 color;",
+    "void main()",
+    "{",
+    "    gl_FragColor = color;",
+    "}"
+};
+
+/* a UV sphere, SLICES*STACKS quads */
+#define SLICES  512
+#define STACKS  256
+#define NUM_VERTICES    ((SLICES+1)*(STACKS+1))
+#define NUM_INDICES     (SLICES*STACKS*6)
+
+/* separate coordinate, normal and texture coordinate buffers, then the interleaved one */
+GLuint separateBuffers[3], interleavedBuffer, indexBuffer;
+
+enum { SEPARATE, INTERLEAVED, NUM_LAYOUTS };
+const char *layoutNames[NUM_LAYOUTS] = { "separate", "interleaved" };
+
+int layout = SEPARATE;
+int drawsPerFrame = 20;
+
+/* frames timed per run, after some untimed warm up frames */
+#define WARMUP_FRAMES   5
+#define TIMED_FRAMES    50
+int frame = 0, runStart;
+
+void createBuffers(void)
+{
+    GLfloat *coords   = malloc(NUM_VERTICES * 3 * sizeof(GLfloat));
+    GLfloat *normals  = malloc(NUM_VERTICES * 3 * sizeof(GLfloat));
+    GLfloat *textures = malloc(NUM_VERTICES * 2 * sizeof(GLfloat));
+    GLfloat *interleaved = malloc(NUM_VERTICES * 8 * sizeof(GLfloat));
+    GLuint *indices = malloc(NUM_INDICES * sizeof(GLuint));
+    int i, j, v, n;
+
+    if (!coords || !normals || !textures || !interleaved || !indices)
+    {
+        fprintf (stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    for (j=0, v=0; j<=STACKS; j++)
+    {
+        double phi = M_PI * j / STACKS;
+        for (i=0; i<=SLICES; i++, v++)
+        {
+            double theta = 2 * M_PI * i / SLICES;
+            normals[v*3+0] = (GLfloat)(sin(phi) * cos(theta));
+            normals[v*3+1] = (GLfloat)(sin(phi) * sin(theta));
+            normals[v*3+2] = (GLfloat)cos(phi);
+            coords[v*3+0] = normals[v*3+0];
+            coords[v*3+1] = normals[v*3+1];
+            coords[v*3+2] = normals[v*3+2];
+            textures[v*2+0] = (GLfloat)i / SLICES;
+            textures[v*2+1] = (GLfloat)j / STACKS;
+        }
+    }
+
+    for (v=0; v<NUM_VERTICES; v++)
+    {
+        interleaved[v*8+0] = coords[v*3+0];
+        interleaved[v*8+1] = coords[v*3+1];
+        interleaved[v*8+2] = coords[v*3+2];
+        interleaved[v*8+3] = normals[v*3+0];
+        interleaved[v*8+4] = normals[v*3+1];
+        interleaved[v*8+5] = normals[v*3+2];
+        interleaved[v*8+6] = textures[v*2+0];
+        interleaved[v*8+7] = textures[v*2+1];
+    }
+
+    for (j=0, n=0; j<STACKS; j++)
+        for (i=0; i<SLICES; i++)
+        {
+            GLuint a = j*(SLICES+1) + i, b = a + SLICES+1;
+            indices[n++] = a; indices[n++] = b;   indices[n++] = a+1;
+            indices[n++] = b; indices[n++] = b+1; indices[n++] = a+1;
+        }
+
+    gl_GenBuffers(3, separateBuffers);
+    gl_BindBuffer(GL_ARRAY_BUFFER, separateBuffers[0]);
+    gl_BufferData(GL_ARRAY_BUFFER, NUM_VERTICES * 3 * sizeof(GLfloat), coords, GL_STATIC_DRAW);
+    gl_BindBuffer(GL_ARRAY_BUFFER, separateBuffers[1]);
+    gl_BufferData(GL_ARRAY_BUFFER, NUM_VERTICES * 3 * sizeof(GLfloat), normals, GL_STATIC_DRAW);
+    gl_BindBuffer(GL_ARRAY_BUFFER, separateBuffers[2]);
+    gl_BufferData(GL_ARRAY_BUFFER, NUM_VERTICES * 2 * sizeof(GLfloat), textures, GL_STATIC_DRAW);
+
+    gl_GenBuffers(1, &interleavedBuffer);
+    gl_BindBuffer(GL_ARRAY_BUFFER, interleavedBuffer);
+    gl_BufferData(GL_ARRAY_BUFFER, NUM_VERTICES * 8 * sizeof(GLfloat), interleaved, GL_STATIC_DRAW);
+    gl_BindBuffer(GL_ARRAY_BUFFER, 0);
+
+    gl_GenBuffers(1, &indexBuffer);
+    gl_BindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    gl_BufferData(GL_ELEMENT_ARRAY_BUFFER, NUM_INDICES * sizeof(GLuint), indices, GL_STATIC_DRAW);
+
+    free(coords);
+    free(normals);
+    free(textures);
+    free(interleaved);
+    free(indices);
+}
+
+void createProgram(void)
+{
+    GLuint program = gl_CreateProgram();
+    GLuint vertexShader = gl_CreateShader(GL_VERTEX_SHADER);
+    GLuint fragmentShader = gl_CreateShader(GL_FRAGMENT_SHADER);
+    GLint status;
+
+    gl_ShaderSource(vertexShader, sizeof(vertexShaderSource) / sizeof(ourGLchar*), vertexShaderSource, NULL);
+    gl_CompileShader(vertexShader);
+    gl_ShaderSource(fragmentShader, sizeof(fragmentShaderSource) / sizeof(ourGLchar*), fragmentShaderSource, NULL);
+    gl_CompileShader(fragmentShader);
+    gl_AttachShader(program, vertexShader);
+    gl_AttachShader(program, fragmentShader);
+    gl_BindAttribLocation(program, ATTRIB_COORD, "fg_coord");
+    gl_BindAttribLocation(program, ATTRIB_NORMAL, "fg_normal");
+    gl_BindAttribLocation(program, ATTRIB_TEXTURE, "fg_texture");
+    gl_LinkProgram(program);
+    gl_GetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE)
+    {
+        fprintf (stderr, "The shaders failed to build\n");
+        exit(1);
+    }
+    gl_UseProgram(program);
+
+    gl_EnableVertexAttribArray(ATTRIB_COORD);
+    gl_EnableVertexAttribArray(ATTRIB_NORMAL);
+    gl_EnableVertexAttribArray(ATTRIB_TEXTURE);
+}
+
+/* point the attributes at the current layout's buffers */
+void setLayout(void)
+{
+    if (layout == SEPARATE)
+    {
+        gl_BindBuffer(GL_ARRAY_BUFFER, separateBuffers[0]);
+        gl_VertexAttribPointer(ATTRIB_COORD, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        gl_BindBuffer(GL_ARRAY_BUFFER, separateBuffers[1]);
+        gl_VertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, 0, 0);
+        gl_BindBuffer(GL_ARRAY_BUFFER, separateBuffers[2]);
+        gl_VertexAttribPointer(ATTRIB_TEXTURE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    }
+    else
+    {
+        const GLsizei stride = 8 * sizeof(GLfloat);
+        gl_BindBuffer(GL_ARRAY_BUFFER, interleavedBuffer);
+        gl_VertexAttribPointer(ATTRIB_COORD, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)0);
+        gl_VertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(3 * sizeof(GLfloat)));
+        gl_VertexAttribPointer(ATTRIB_TEXTURE, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(6 * sizeof(GLfloat)));
+    }
+    gl_BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void display(void)
+{
+    int i;
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    for (i=0; i<drawsPerFrame; i++)
+        glDrawElements(GL_TRIANGLES, NUM_INDICES, GL_UNSIGNED_INT, 0);
+    glutSwapBuffers();
+    /* time the drawing, not how far ahead of it the driver lets us get */
+    glFinish();
+
+    if (++frame == WARMUP_FRAMES)
+        runStart = glutGet(GLUT_ELAPSED_TIME);
+    else if (frame == WARMUP_FRAMES + TIMED_FRAMES)
+    {
+        double ms = (double)(glutGet(GLUT_ELAPSED_TIME) - runStart) / TIMED_FRAMES;
+
+        printf("%-12s %8.2f ms per frame, %7.1f million indexed vertices/s\n", layoutNames[layout],
+               ms, (double)NUM_INDICES * drawsPerFrame / ms / 1000.0);
+        fflush(stdout);
+
+        layout = (layout + 1) % NUM_LAYOUTS;
+        setLayout();
+        frame = 0;
+    }
+}
+
+void key(unsigned char key, int x, int y)
+{
+    switch (key)
+    {
+    case 27 :
+    case 'Q':
+    case 'q': glutLeaveMainLoop () ; break;
+
+    case '=':
+    case '+': drawsPerFrame++; frame = 0; printf("%d draws per frame\n", drawsPerFrame); break;
+
+    case '-':
+    case '_': if (drawsPerFrame > 1) drawsPerFrame--; frame = 0; printf("%d draws per frame\n", drawsPerFrame); break;
+
+    default:
+        break;
+    }
+}
+
+void idle(void)
+{
+    glutPostRedisplay();
+}
+
+int
+main(int argc, char *argv[])
+{
+    glutInitWindowSize(64,64);
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_RGB | GLUT_DOUBLE | GLUT_DEPTH);
+
+    glutCreateWindow("Vertex layouts");
+
+    if (!initFunctions())
+    {
+        fprintf (stderr, "OpenGL 2.0 buffer objects and shaders are needed\n");
+        return 1;
+    }
+
+    createBuffers();
+    createProgram();
+    setLayout();
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+
+    glutDisplayFunc(display);
+    glutKeyboardFunc(key);
+    glutIdleFunc(idle);
+
+    printf("Timing %d draws of %d indexed vertices per frame\n", drawsPerFrame, NUM_INDICES);
+    glutMainLoop();
+
+    return EXIT_SUCCESS;
+}
@@ -149,18 +149,18 @@ static unsigned char key_ascii(struct android_app* app, AInputEvent* event) {
   return ascii;
 }
 
-unsigned long fgPlatformSystemTime ( void )
+fg_time_t fgPlatformSystemTime ( void )
 {
   struct timeval now;
   gettimeofday( &now, NULL );
-  return now.tv_usec/1000 + now.tv_sec*1000;
+  return now.tv_usec + (fg_time_t)now.tv_sec*1000000;
 }
 
 /*
  * Does the magic required to relinquish the CPU until something interesting
  * happens.
  */
-void fgPlatformSleepForEvents( long msec )
+void fgPlatformSleepForEvents( fg_time_t usec )
 {
     /* Android's NativeActivity relies on a Looper/ALooper object to
        notify about events.  The Looper object is plugged on two
@@ -171,6 +171,41 @@ void fgPlatformSleepForEvents( long msec )
        SleepForEvents. */
 }
 
+void fgPlatformWakeMainLoop( void )
+{
+    /* Nothing to do, as the main loop never sleeps (see above) */
+}
+
+GLboolean fgPlatformAddInputFd( int fd, int events, GLboolean isNew )
+{
+    /* XXX Not supported: the descriptors would have to go to the ALooper */
+    return GL_FALSE;
+}
+
+void fgPlatformRemoveInputFd( int fd )
+{
+}
+
+void fgPlatformProcessInputFds( void )
+{
+}
+
+int fgPlatformGetEventFds( int *fds, int *events, int maxFds )
+{
+    /* XXX Not supported: the main loop never sleeps (see above) */
+    return 0;
+}
+
+GLboolean fgPlatformHasPendingEvents( void )
+{
+    /* Without descriptors to wait on, have glutGetNextTimeout() return 0 */
+    return GL_TRUE;
+}
+
+void fgPlatformDrainEventFds( void )
+{
+}
+
 /**
  * Process the next input event.
  */
@@ -30,8 +30,8 @@
 #include "fg_internal.h"
 
 extern void fgPlatformProcessSingleEvent(void);
-extern unsigned long fgPlatformSystemTime(void);
-extern void fgPlatformSleepForEvents(long msec);
+extern fg_time_t fgPlatformSystemTime(void);
+extern void fgPlatformSleepForEvents(fg_time_t usec);
 extern void fgPlatformMainLoopPreliminaryWork(void);
 
 #endif
@@ -168,11 +168,11 @@ fg_time_t fgPlatformSystemTime ( void )
 #ifdef CLOCK_MONOTONIC
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
-    return now.tv_nsec/1000000 + now.tv_sec*1000;
+    return now.tv_nsec/1000 + (fg_time_t)now.tv_sec*1000000;
 #elif defined(HAVE_GETTIMEOFDAY)
     struct timeval now;
     gettimeofday( &now, NULL );
-    return now.tv_usec/1000 + now.tv_sec*1000;
+    return now.tv_usec + (fg_time_t)now.tv_sec*1000000;
 #endif
 }
 
@@ -180,14 +180,52 @@ fg_time_t fgPlatformSystemTime ( void )
  * Does the magic required to relinquish the CPU until something interesting
  * happens.
  */
-void fgPlatformSleepForEvents( fg_time_t msec )
+void fgPlatformSleepForEvents( fg_time_t usec )
 {
+    /* Round up, so that we don't wake up just short of a timer */
+    int msec = (int)( ( usec + 999 ) / 1000 );
+
     if(fgStructure.CurrentWindow && fgDisplay.pDisplay.event == NULL &&
-            bps_get_event(&fgDisplay.pDisplay.event, (int)msec) != BPS_SUCCESS) {
+            bps_get_event(&fgDisplay.pDisplay.event, msec) != BPS_SUCCESS) {
         LOGW("BPS couldn't get event");
     }
 }
 
+void fgPlatformWakeMainLoop( void )
+{
+    /* XXX Not supported: calls from other threads wait for the next event or timer */
+}
+
+GLboolean fgPlatformAddInputFd( int fd, int events, GLboolean isNew )
+{
+    /* XXX Not supported: the descriptors would have to go to bps_add_fd() */
+    return GL_FALSE;
+}
+
+void fgPlatformRemoveInputFd( int fd )
+{
+}
+
+void fgPlatformProcessInputFds( void )
+{
+}
+
+int fgPlatformGetEventFds( int *fds, int *events, int maxFds )
+{
+    /* XXX Not supported: the events come from bps_get_event() */
+    return 0;
+}
+
+GLboolean fgPlatformHasPendingEvents( void )
+{
+    /* Without descriptors to wait on, have glutGetNextTimeout() return 0 */
+    return GL_TRUE;
+}
+
+void fgPlatformDrainEventFds( void )
+{
+}
+
 void handle_left_mouse(int x, int y, int height, int eventType, SFG_Window* window)
 {
     bool handled = false;
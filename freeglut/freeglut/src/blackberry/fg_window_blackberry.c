@@ -192,7 +192,7 @@ void fgPlatformOpenWindow( SFG_Window* window, const char* title,
 
     /* Save window and set state */
     window->Window.Handle = sWindow;
-    window->State.WorkMask |= GLUT_INIT_WORK;
+    fgAddToWindowWorkList( window, GLUT_INIT_WORK );
     window->State.IsFullscreen = GL_TRUE; //XXX Always fullscreen for now
 
     /* Create context */
@@ -124,7 +124,10 @@ EGLContext fghCreateNewContextEGL( SFG_Window* window ) {
 
 void fgPlatformSetWindow ( SFG_Window *window )
 {
-  if ( window != fgStructure.CurrentWindow && window) {
+  /* Skip the switch if the window's surface and context are bound already */
+  if ( window &&
+       ( eglGetCurrentContext() != window->Window.Context ||
+         eglGetCurrentSurface(EGL_DRAW) != window->Window.pContext.egl.Surface ) ) {
     if (eglMakeCurrent(fgDisplay.pDisplay.egl.Display,
                window->Window.pContext.egl.Surface,
                window->Window.pContext.egl.Surface,
@@ -160,7 +163,7 @@ void fghPlatformOpenWindowEGL( SFG_Window* window )
 void fghPlatformCloseWindowEGL( SFG_Window* window )
 {
   /* Based on fg_window_mswin fgPlatformCloseWindow */
-  if( fgStructure.CurrentWindow == window )
+  if( eglGetCurrentSurface(EGL_DRAW) == window->Window.pContext.egl.Surface )
     eglMakeCurrent(fgDisplay.pDisplay.egl.Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
 
   if (window->Window.Context != EGL_NO_CONTEXT) {
@@ -44,51 +44,115 @@ void FGAPIENTRY glutIdleFuncUcall( FGCBIdleUC callback, FGCBUserData userData )
 
 IMPLEMENT_GLUT_CALLBACK_FUNC_ARG0(Idle)
 
+/* Creates a timer firing after the given number of microseconds */
+static void fghAddTimerFunc( fg_time_t timeOut, FGCBTimerUC callback, int timerID, FGCBUserData userData )
+{
+    SFG_Timer *timer = fgNewTimer( );
+
+    timer->Callback     = callback;
+    timer->CallbackData = userData;
+    timer->ID           = timerID;
+    timer->TriggerTime  = fgElapsedTime() + timeOut;
+
+    /* Queue it, see fg_main.c */
+    fgAddTimer( timer );
+}
+
 /* Creates a timer and sets its callback */
 void FGAPIENTRY glutTimerFuncUcall( unsigned int timeOut, FGCBTimerUC callback, int timerID, FGCBUserData userData )
 {
-    SFG_Timer *timer, *node;
-
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFuncUcall" );
+    fghAddTimerFunc( (fg_time_t)timeOut * 1000, callback, timerID, userData );
+}
+
+/* Same as above, but with the time out given in microseconds */
+void FGAPIENTRY glutTimerFuncUsUcall( unsigned int timeOut, FGCBTimerUC callback, int timerID, FGCBUserData userData )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFuncUsUcall" );
+    fghAddTimerFunc( timeOut, callback, timerID, userData );
+}
+
+IMPLEMENT_CALLBACK_FUNC_CB_ARG1(Timer, Timer)
+
+void FGAPIENTRY glutTimerFunc( unsigned int timeOut, FGCBTimer callback, int timerID )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFunc" );
+    if( callback )
+    {
+        FGCBTimer* reference = &callback;
+        glutTimerFuncUcall( timeOut, fghTimerFuncCallback, timerID, *((FGCBUserData*)reference) );
+    }
+    else
+        glutTimerFuncUcall( timeOut, NULL, timerID, NULL );
+}
 
-    if( (timer = fgState.FreeTimers.Last) )
+void FGAPIENTRY glutTimerFuncUs( unsigned int timeOut, FGCBTimer callback, int timerID )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFuncUs" );
+    if( callback )
     {
-        fgListRemove( &fgState.FreeTimers, &timer->Node );
+        FGCBTimer* reference = &callback;
+        glutTimerFuncUsUcall( timeOut, fghTimerFuncCallback, timerID, *((FGCBUserData*)reference) );
     }
     else
+        glutTimerFuncUsUcall( timeOut, NULL, timerID, NULL );
+}
+
+/* Removes all pending timers registered with the given timer ID */
+void FGAPIENTRY glutCancelTimer( int timerID )
+{
+    SFG_List *bucket;
+    SFG_Timer *timer, *next;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutCancelTimer" );
+
+    bucket = &fgState.TimerIDs[ (unsigned int)timerID % FREEGLUT_TIMER_ID_BUCKETS ];
+    for( timer = bucket->First; timer; timer = next )
     {
-        if( ! (timer = malloc(sizeof(SFG_Timer))) )
-            fgError( "Fatal error: "
-                     "Memory allocation failure in glutTimerFunc()" );
+        next = timer->Node.Next;
+        if( timer->ID == timerID && !timer->Internal )
+            fgRemoveTimer( timer );
     }
+}
 
-    timer->Callback     = callback;
-    timer->CallbackData = userData;
-    timer->ID           = timerID;
-    timer->TriggerTime  = fgElapsedTime() + timeOut;
+/*
+ * Has the main loop call back when the descriptor is ready for the
+ * GLUT_INPUT_* events, or stop waiting on it if there are none
+ */
+void FGAPIENTRY glutAddInputFdUcall( int fd, int events, FGCBInputFdUC callback, FGCBUserData userData )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutAddInputFdUcall" );
 
-    /* Insert such that timers are sorted by end-time */
-    for( node = fgState.Timers.First; node; node = node->Node.Next )
+    events &= GLUT_INPUT_READABLE | GLUT_INPUT_WRITABLE;
+    if( fd < 0 || !events || !callback )
     {
-        if( node->TriggerTime > timer->TriggerTime )
-            break;
+        fgRemoveInputFd( fd );
+        return;
     }
 
-    fgListInsert( &fgState.Timers, &node->Node, &timer->Node );
+    if( !fgAddInputFd( fd, events, callback, userData ) )
+        fgWarning( "glutAddInputFd(): can't wait on descriptor %d", fd );
 }
 
-IMPLEMENT_CALLBACK_FUNC_CB_ARG1(Timer, Timer)
+IMPLEMENT_CALLBACK_FUNC_CB_ARG2(InputFd, InputFd)
 
-void FGAPIENTRY glutTimerFunc( unsigned int timeOut, FGCBTimer callback, int timerID )
+void FGAPIENTRY glutAddInputFd( int fd, int events, FGCBInputFd callback )
 {
-    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutTimerFunc" );
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutAddInputFd" );
     if( callback )
     {
-        FGCBTimer* reference = &callback;
-        glutTimerFuncUcall( timeOut, fghTimerFuncCallback, timerID, *((FGCBUserData*)reference) );
+        FGCBInputFd* reference = &callback;
+        glutAddInputFdUcall( fd, events, fghInputFdFuncCallback, *((FGCBUserData*)reference) );
     }
     else
-        glutTimerFuncUcall( timeOut, NULL, timerID, NULL );
+        glutAddInputFdUcall( fd, events, NULL, NULL );
+}
+
+/* Stops waiting on a descriptor given to glutAddInputFd() */
+void FGAPIENTRY glutRemoveInputFd( int fd )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutRemoveInputFd" );
+    fgRemoveInputFd( fd );
 }
 
 /* Deprecated version of glutMenuStatusFunc callback setting method */
@@ -263,12 +327,8 @@ void FGAPIENTRY glutJoystickFuncUcall( FGCBJoystickUC callback, int pollInterval
     SET_CURRENT_WINDOW_CALLBACK( Joystick );
     fgStructure.CurrentWindow->State.JoystickPollRate = pollInterval;
 
-    /* set last poll time such that joystick will be polled asap */
-    fgStructure.CurrentWindow->State.JoystickLastPoll = fgElapsedTime();
-    if (fgStructure.CurrentWindow->State.JoystickLastPoll < pollInterval)
-        fgStructure.CurrentWindow->State.JoystickLastPoll = 0;
-    else
-        fgStructure.CurrentWindow->State.JoystickLastPoll -= pollInterval;
+    /* Queue (or drop) the window's polling timer, see fg_joystick.c */
+    fgJoystickUpdateTimer( fgStructure.CurrentWindow );
 }
 
 static void fghJoystickFuncCallback( unsigned int buttons, int axis0, int axis1, int axis2, FGCBUserData userData )
@@ -47,7 +47,7 @@ void FGAPIENTRY glutPostRedisplay( void )
                 " with no current window defined.", "glutPostRedisplay" ) ;
     }
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_DISPLAY_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_DISPLAY_WORK );
 }
 
 /*
@@ -63,6 +63,11 @@ void FGAPIENTRY glutSwapBuffers( void )
      * about "SwapBuffers"?
      */
     glFlush( );
+
+    /* Stroke characters of the next frame start at the origin again */
+    fgStructure.CurrentWindow->Window.StrokePenX = 0.0f;
+    fgStructure.CurrentWindow->Window.StrokePenY = 0.0f;
+
     if( ! fgStructure.CurrentWindow->Window.DoubleBuffered )
         return;
 
@@ -98,7 +103,7 @@ void FGAPIENTRY glutPostWindowRedisplay( int windowID )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPostWindowRedisplay" );
     window = fgWindowByID( windowID );
     freeglut_return_if_fail( window );
-    window->State.WorkMask |= GLUT_DISPLAY_WORK;
+    fgAddToWindowWorkList( window, GLUT_DISPLAY_WORK );
 }
 
 /*** END OF FILE ***/
@@ -27,6 +27,7 @@
 
 #include <GL/freeglut.h>
 #include "fg_internal.h"
+#include "fg_gl2.h"
 
 /*
  * TODO BEFORE THE STABLE RELEASE:
@@ -90,6 +91,680 @@ static SFG_StrokeFont* fghStrokeByID( void* font )
     return 0;
 }
 
+/*
+ * Drawing bitmap fonts from glyph atlases, see GLUT_BITMAP_FONT_ATLAS
+ *
+ * Each font is rasterized once per context into a texture holding a 16x16
+ * grid of cells, one per character, each as large as the font's widest
+ * glyph plus a blank texel of padding. Strings are then drawn as batches
+ * of textured quads, one unit per pixel, instead of one glBitmap call per
+ * character.
+ *
+ * With the fixed function pipeline, the quads are placed and colored the
+ * way glBitmap would place and color the characters, and the raster
+ * position is moved along the same. With the user's shaders (see
+ * glutSetVertexAttribCoord3 and glutSetVertexAttribTexCoord2), the quads
+ * start at the origin of the current coordinate system, and the atlas is
+ * bound to the active texture unit: glyph coverage is in its red channel.
+ */
+
+/* The bitmap fonts, in the order of their atlases in SFG_Context */
+static SFG_Font* const bitmapFonts[ FREEGLUT_NUM_BITMAP_FONTS ] =
+{
+    &fgFontFixed8x13, &fgFontFixed9x15,
+    &fgFontHelvetica10, &fgFontHelvetica12, &fgFontHelvetica18,
+    &fgFontTimesRoman10, &fgFontTimesRoman24
+};
+
+/* The layout of a font's atlas is the same for every context */
+typedef struct tagSFG_FontAtlas SFG_FontAtlas;
+struct tagSFG_FontAtlas
+{
+    int CellWidth, CellHeight;      /* The grid's cells, in texels       */
+    int Width, Height;              /* The texture's size, powers of two */
+};
+static SFG_FontAtlas fontAtlases[ FREEGLUT_NUM_BITMAP_FONTS ];
+
+/* Quads are drawn in batches of this many characters at most */
+#define FGH_GLYPHS_PER_BATCH 64
+
+static int fghFontIndex( const SFG_Font* font )
+{
+    int i;
+
+    for( i = 0; i < FREEGLUT_NUM_BITMAP_FONTS; i++ )
+        if( bitmapFonts[ i ] == font )
+            return i;
+
+    return -1;
+}
+
+static const SFG_FontAtlas* fghFontAtlas( int index )
+{
+    SFG_FontAtlas *atlas = &fontAtlases[ index ];
+
+    if( !atlas->CellWidth )
+    {
+        const SFG_Font *font = bitmapFonts[ index ];
+        int c, width = 0;
+
+        for( c = 0; c < font->Quantity; c++ )
+            if( font->Characters[ c ][ 0 ] > width )
+                width = font->Characters[ c ][ 0 ];
+
+        atlas->CellWidth  = width + 1;
+        atlas->CellHeight = font->Height + 1;
+        for( atlas->Width = 1; atlas->Width < 16 * atlas->CellWidth; atlas->Width *= 2 )
+            ;
+        for( atlas->Height = 1; atlas->Height < 16 * atlas->CellHeight; atlas->Height *= 2 )
+            ;
+    }
+
+    return atlas;
+}
+
+/*
+ * Core and forward-compatible contexts lack the luminance and intensity
+ * texture formats, but then they lack the fixed function pipeline too.
+ */
+static GLboolean fghHasIntensityTextures( void )
+{
+    return fghContextHasFixedPipeline( );
+}
+
+/* Rasterizes a font into a new texture of the current context */
+static GLuint fghCreateFontTexture( const SFG_Font* font, const SFG_FontAtlas* atlas )
+{
+    GLubyte *texels = calloc( atlas->Width * atlas->Height, 1 );
+    GLint binding, alignment, rowLength, skipRows, skipPixels;
+    GLuint texture;
+    int c, x, y;
+
+    if( !texels )
+        fgError( "Failed to allocate memory in fghCreateFontTexture" );
+
+    /* glBitmap data is packed MSB first, bottom row first, rows padded to bytes */
+    for( c = 0; c < font->Quantity; c++ )
+    {
+        const GLubyte *face = font->Characters[ c ];
+        int width = face[ 0 ], rowBytes = ( width + 7 ) / 8;
+        GLubyte *cell = texels + ( c / 16 ) * atlas->CellHeight * atlas->Width +
+                                 ( c % 16 ) * atlas->CellWidth;
+
+        for( y = 0; y < font->Height; y++ )
+            for( x = 0; x < width; x++ )
+                if( face[ 1 + y * rowBytes + x / 8 ] & ( 0x80 >> ( x % 8 ) ) )
+                    cell[ y * atlas->Width + x ] = 255;
+    }
+
+    glGetIntegerv( GL_TEXTURE_BINDING_2D,  &binding    );
+    glGetIntegerv( GL_UNPACK_ALIGNMENT,    &alignment  );
+    glGetIntegerv( GL_UNPACK_ROW_LENGTH,   &rowLength  );
+    glGetIntegerv( GL_UNPACK_SKIP_ROWS,    &skipRows   );
+    glGetIntegerv( GL_UNPACK_SKIP_PIXELS,  &skipPixels );
+    glPixelStorei( GL_UNPACK_ALIGNMENT,    1 );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH,   0 );
+    glPixelStorei( GL_UNPACK_SKIP_ROWS,    0 );
+    glPixelStorei( GL_UNPACK_SKIP_PIXELS,  0 );
+
+    glGenTextures( 1, &texture );
+    glBindTexture( GL_TEXTURE_2D, texture );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    if( fghHasIntensityTextures( ) )
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_INTENSITY, atlas->Width, atlas->Height, 0,
+                      GL_LUMINANCE, GL_UNSIGNED_BYTE, texels );
+    else
+        glTexImage2D( GL_TEXTURE_2D, 0, FGH_R8, atlas->Width, atlas->Height, 0,
+                      GL_RED, GL_UNSIGNED_BYTE, texels );
+
+    glBindTexture( GL_TEXTURE_2D, binding );
+    glPixelStorei( GL_UNPACK_ALIGNMENT,    alignment  );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH,   rowLength  );
+    glPixelStorei( GL_UNPACK_SKIP_ROWS,    skipRows   );
+    glPixelStorei( GL_UNPACK_SKIP_PIXELS,  skipPixels );
+
+    free( texels );
+    return texture;
+}
+
+/*
+ * Fills in the quads of the next characters of a string, two triangles of
+ * x, y, s, t vertices each, placed relative to where the string started.
+ * Moves the string and the pen along, and returns the number of vertices.
+ */
+static int fghBatchGlyphs( const SFG_Font* font, const SFG_FontAtlas* atlas,
+                           const unsigned char** string, GLboolean newlines,
+                           float* penX, float* penY, GLfloat* vertices )
+{
+    GLfloat *v = vertices;
+    int numGlyphs = 0;
+    unsigned char c;
+
+    while( numGlyphs < FGH_GLYPHS_PER_BATCH && ( c = **string ) )
+    {
+        const GLubyte *face = font->Characters[ c ];
+        GLfloat x0, y0, x1, y1, s0, t0, s1, t1;
+
+        ( *string )++;
+        if( c == '\n' && newlines )
+        {
+            *penX = 0.0f;
+            *penY -= ( float )font->Height;
+            continue;
+        }
+
+        /* Where glBitmap would put the character */
+        x0 = *penX - font->xorig;
+        y0 = *penY - font->yorig;
+        x1 = x0 + face[ 0 ];
+        y1 = y0 + font->Height;
+        s0 = ( GLfloat )( ( c % 16 ) * atlas->CellWidth  ) / atlas->Width;
+        t0 = ( GLfloat )( ( c / 16 ) * atlas->CellHeight ) / atlas->Height;
+        s1 = s0 + ( GLfloat )face[ 0 ] / atlas->Width;
+        t1 = t0 + ( GLfloat )font->Height / atlas->Height;
+
+        *v++ = x0; *v++ = y0; *v++ = s0; *v++ = t0;
+        *v++ = x1; *v++ = y0; *v++ = s1; *v++ = t0;
+        *v++ = x1; *v++ = y1; *v++ = s1; *v++ = t1;
+        *v++ = x0; *v++ = y0; *v++ = s0; *v++ = t0;
+        *v++ = x1; *v++ = y1; *v++ = s1; *v++ = t1;
+        *v++ = x0; *v++ = y1; *v++ = s0; *v++ = t1;
+
+        *penX += face[ 0 ];
+        numGlyphs++;
+    }
+
+    return numGlyphs * 6;
+}
+
+/*
+ * Disables texturing on all units but the first, and every target but
+ * GL_TEXTURE_2D on the first: 1D textures would modulate the glyphs, and
+ * 3D, cube map and rectangle ones take precedence over them. The caller
+ * has pushed the enables and texture state of all units, and the client
+ * vertex arrays, which hold the client active unit.
+ */
+static void fghUseOnlyTexture2D( void )
+{
+    int unit;
+
+    for( unit = fgState.NumTextureUnits - 1; unit >= 0; unit-- )
+    {
+        if( fghActiveTexture )
+            fghActiveTexture( FGH_TEXTURE0 + unit );
+
+        glDisable( GL_TEXTURE_1D );
+        if( unit )
+            glDisable( GL_TEXTURE_2D );
+        if( fgState.HasTexture3D )
+            glDisable( FGH_TEXTURE_3D );
+        if( fgState.HasTextureCubeMap )
+            glDisable( FGH_TEXTURE_CUBE_MAP );
+        if( fgState.HasTextureRectangle )
+            glDisable( FGH_TEXTURE_RECTANGLE );
+    }
+
+    if( fghClientActiveTexture )
+        fghClientActiveTexture( FGH_TEXTURE0 );
+}
+
+static void fghDrawBitmapAtlas11( const SFG_Font* font, const SFG_FontAtlas* atlas, GLuint texture,
+                                  const unsigned char* string, GLboolean newlines )
+{
+    GLfloat vertices[ FGH_GLYPHS_PER_BATCH * 6 * 4 ];
+    GLfloat raster[ 4 ], color[ 4 ];
+    GLint viewport[ 4 ];
+    GLboolean valid;
+    float penX = 0.0f, penY = 0.0f;
+    int numVertices;
+
+    /* Like glBitmap, don't draw nor move anything from an invalid position */
+    glGetBooleanv( GL_CURRENT_RASTER_POSITION_VALID, &valid );
+    if( !valid )
+        return;
+    glGetFloatv( GL_CURRENT_RASTER_POSITION, raster );
+    glGetFloatv( GL_CURRENT_RASTER_COLOR, color );
+    glGetIntegerv( GL_VIEWPORT, viewport );
+
+    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT | GL_POLYGON_BIT |
+                  GL_COLOR_BUFFER_BIT | GL_VIEWPORT_BIT | GL_TRANSFORM_BIT );
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+
+    /* glBitmap fragments are neither lit nor textured, and take the raster color */
+    glDisable( GL_LIGHTING );
+    glDisable( GL_CULL_FACE );
+    glDisable( GL_POLYGON_STIPPLE );
+    fghUseOnlyTexture2D( );
+    glDisable( GL_TEXTURE_GEN_S );
+    glDisable( GL_TEXTURE_GEN_T );
+    glDisable( GL_TEXTURE_GEN_Q );
+    glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
+    glEnable( GL_TEXTURE_2D );
+    glBindTexture( GL_TEXTURE_2D, texture );
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+    glEnable( GL_ALPHA_TEST );
+    glAlphaFunc( GL_GREATER, 0.0f );
+    glColor4fv( color );
+
+    /* Window coordinates, at the raster position's depth */
+    glDepthRange( 0.0, 1.0 );
+    glMatrixMode( GL_TEXTURE );
+    glPushMatrix( );
+    glLoadIdentity( );
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix( );
+    glLoadIdentity( );
+    glOrtho( viewport[ 0 ], viewport[ 0 ] + viewport[ 2 ],
+             viewport[ 1 ], viewport[ 1 ] + viewport[ 3 ], -1.0, 1.0 );
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix( );
+    glLoadIdentity( );
+    glTranslatef( ( float )floor( raster[ 0 ] ), ( float )floor( raster[ 1 ] ),
+                  1.0f - 2.0f * raster[ 2 ] );
+
+    if( fgState.HasOpenGL20 )
+        fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+    glDisableClientState( GL_COLOR_ARRAY );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glVertexPointer( 2, GL_FLOAT, 4 * sizeof( GLfloat ), vertices );
+    glTexCoordPointer( 2, GL_FLOAT, 4 * sizeof( GLfloat ), vertices + 2 );
+
+    while( *string )
+        if( ( numVertices = fghBatchGlyphs( font, atlas, &string, newlines, &penX, &penY, vertices ) ) )
+            glDrawArrays( GL_TRIANGLES, 0, numVertices );
+
+    glPopMatrix( );
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix( );
+    glMatrixMode( GL_TEXTURE );
+    glPopMatrix( );
+
+    glPopClientAttrib( );
+    glPopAttrib( );
+
+    /* Leave the raster position where glBitmap would have */
+    glBitmap( 0, 0, 0.0f, 0.0f, penX, penY, NULL );
+}
+
+static void fghDrawBitmapAtlas20( const SFG_Font* font, const SFG_FontAtlas* atlas, GLuint texture,
+                                  const unsigned char* string, GLboolean newlines,
+                                  GLint attribute_v_coord, GLint attribute_v_texture )
+{
+    SFG_Context *context = &fgStructure.CurrentWindow->Window;
+    GLfloat vertices[ FGH_GLYPHS_PER_BATCH * 6 * 4 ];
+    float penX = 0.0f, penY = 0.0f;
+    GLint binding;
+    int numVertices;
+
+    if( !context->FontBuffer )
+        fghGenBuffers( 1, &context->FontBuffer );
+
+    glGetIntegerv( GL_TEXTURE_BINDING_2D, &binding );
+    glBindTexture( GL_TEXTURE_2D, texture );
+
+    fghBindBuffer( FGH_ARRAY_BUFFER, context->FontBuffer );
+    fghEnableVertexAttribArray( attribute_v_coord );
+    fghEnableVertexAttribArray( attribute_v_texture );
+    fghVertexAttribPointer( attribute_v_coord, 2, GL_FLOAT, GL_FALSE,
+                            4 * sizeof( GLfloat ), ( GLvoid * )0 );
+    fghVertexAttribPointer( attribute_v_texture, 2, GL_FLOAT, GL_FALSE,
+                            4 * sizeof( GLfloat ), ( GLvoid * )( 2 * sizeof( GLfloat ) ) );
+
+    while( *string )
+        if( ( numVertices = fghBatchGlyphs( font, atlas, &string, newlines, &penX, &penY, vertices ) ) )
+        {
+            fghBufferData( FGH_ARRAY_BUFFER, numVertices * 4 * sizeof( GLfloat ),
+                           vertices, FGH_STREAM_DRAW );
+            glDrawArrays( GL_TRIANGLES, 0, numVertices );
+        }
+
+    fghDisableVertexAttribArray( attribute_v_coord );
+    fghDisableVertexAttribArray( attribute_v_texture );
+    fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+    glBindTexture( GL_TEXTURE_2D, binding );
+}
+
+/*
+ * Draws a string from the font's atlas, creating the atlas if needed
+ */
+static void fghDrawBitmapAtlas( const SFG_Font* font, const unsigned char* string, GLboolean newlines )
+{
+    SFG_Context *context = &fgStructure.CurrentWindow->Window;
+    int index = fghFontIndex( font );
+    const SFG_FontAtlas *atlas = fghFontAtlas( index );
+
+    if( !context->FontTextures[ index ] )
+        context->FontTextures[ index ] = fghCreateFontTexture( font, atlas );
+
+    if( fgState.HasOpenGL20 &&
+        context->attribute_v_coord != -1 && context->attribute_v_texture != -1 )
+        fghDrawBitmapAtlas20( font, atlas, context->FontTextures[ index ], string, newlines,
+                              context->attribute_v_coord, context->attribute_v_texture );
+    else
+        fghDrawBitmapAtlas11( font, atlas, context->FontTextures[ index ], string, newlines );
+}
+
+/*
+ * Releases the glyph atlases of a window's context, see fgDestroyWindow
+ */
+void fgDestroyFontTextures( SFG_Window *window )
+{
+    SFG_Context *context = &window->Window;
+    GLboolean used = context->FontBuffer != 0;
+    int i;
+
+    for( i = 0; i < FREEGLUT_NUM_BITMAP_FONTS; i++ )
+        if( context->FontTextures[ i ] )
+            used = GL_TRUE;
+    if( !used )
+        return;
+
+    fgSetWindow( window );
+    for( i = 0; i < FREEGLUT_NUM_BITMAP_FONTS; i++ )
+        if( context->FontTextures[ i ] )
+        {
+            glDeleteTextures( 1, &context->FontTextures[ i ] );
+            context->FontTextures[ i ] = 0;
+        }
+    if( context->FontBuffer )
+    {
+        fghDeleteBuffers( 1, &context->FontBuffer );
+        context->FontBuffer = 0;
+    }
+}
+
+/*
+ * Drawing stroke fonts from vertex arrays
+ *
+ * The strips of a stroke font are flattened once into a single array of
+ * x, y vertices, character after character, along with the number of
+ * vertices in each strip and where each character's vertices and strips
+ * start. A string is drawn by copying its characters' vertices, moved
+ * along by the pen, into a scratch array, and drawing all their strips
+ * with one glMultiDrawArrays call (or one glDrawArrays per strip when
+ * that is missing) instead of a glBegin/glEnd per strip.
+ *
+ * With the fixed function pipeline, the modelview matrix is then moved
+ * to where the next character would go, as one glTranslatef per
+ * character used to. With the user's shaders (see
+ * glutSetVertexAttribCoord3), the string starts at the origin of the
+ * current coordinate system and nothing is moved.
+ */
+
+/* The stroke fonts, in the order of their arrays below */
+#define FGH_NUM_STROKE_FONTS 2
+static SFG_StrokeFont* const strokeFonts[ FGH_NUM_STROKE_FONTS ] =
+{
+    &fgStrokeRoman, &fgStrokeMonoRoman
+};
+
+/* A stroke font flattened into arrays, the same for every context */
+typedef struct tagSFG_StrokeArrays SFG_StrokeArrays;
+struct tagSFG_StrokeArrays
+{
+    GLfloat *Vertices;      /* x, y of every strip of every character */
+    GLsizei *StripCounts;   /* The number of vertices of each strip   */
+    int     *FirstVertex;   /* Per character, and one past the last   */
+    int     *FirstStrip;    /* Same, for the strips                   */
+};
+static SFG_StrokeArrays strokeArrays[ FGH_NUM_STROKE_FONTS ];
+
+/* The vertices and strips of the string being drawn */
+static GLfloat *strokeVertices   = NULL;
+static GLint   *strokeFirsts     = NULL;
+static GLsizei *strokeCounts     = NULL;
+static int      strokeVertexSize = 0;
+static int      strokeStripSize  = 0;
+
+static const SFG_StrokeArrays* fghStrokeArrays( const SFG_StrokeFont* font )
+{
+    SFG_StrokeArrays *arrays = &strokeArrays[ font == strokeFonts[ 0 ] ? 0 : 1 ];
+    int c, i, j, numVertices = 0, numStrips = 0;
+    GLfloat *v;
+
+    if( arrays->Vertices )
+        return arrays;
+
+    for( c = 0; c < font->Quantity; c++ )
+    {
+        const SFG_StrokeChar *schar = font->Characters[ c ];
+        if( schar )
+        {
+            for( i = 0; i < schar->Number; i++ )
+                numVertices += schar->Strips[ i ].Number;
+            numStrips += schar->Number;
+        }
+    }
+
+    arrays->Vertices    = malloc( numVertices * 2 * sizeof( GLfloat ) );
+    arrays->StripCounts = malloc( numStrips * sizeof( GLsizei ) );
+    arrays->FirstVertex = malloc( ( font->Quantity + 1 ) * sizeof( int ) );
+    arrays->FirstStrip  = malloc( ( font->Quantity + 1 ) * sizeof( int ) );
+    if( !arrays->Vertices || !arrays->StripCounts || !arrays->FirstVertex || !arrays->FirstStrip )
+        fgError( "Failed to allocate memory in fghStrokeArrays" );
+
+    for( c = 0, v = arrays->Vertices, numVertices = 0, numStrips = 0; c < font->Quantity; c++ )
+    {
+        const SFG_StrokeChar *schar = font->Characters[ c ];
+
+        arrays->FirstVertex[ c ] = numVertices;
+        arrays->FirstStrip [ c ] = numStrips;
+        if( !schar )
+            continue;
+
+        for( i = 0; i < schar->Number; i++ )
+        {
+            const SFG_StrokeStrip *strip = &schar->Strips[ i ];
+
+            for( j = 0; j < strip->Number; j++ )
+            {
+                *v++ = strip->Vertices[ j ].X;
+                *v++ = strip->Vertices[ j ].Y;
+            }
+            arrays->StripCounts[ numStrips++ ] = strip->Number;
+            numVertices += strip->Number;
+        }
+    }
+    arrays->FirstVertex[ font->Quantity ] = numVertices;
+    arrays->FirstStrip [ font->Quantity ] = numStrips;
+
+    return arrays;
+}
+
+/* Makes sure the scratch arrays can hold a string of this size */
+static void fghReserveStrokeString( int numVertices, int numStrips )
+{
+    if( strokeVertexSize < numVertices )
+    {
+        free( strokeVertices );
+        strokeVertices = malloc( numVertices * 2 * sizeof( GLfloat ) );
+        if( !strokeVertices )
+        {
+            strokeVertexSize = 0;
+            fgError( "Failed to allocate memory in fghReserveStrokeString" );
+        }
+        strokeVertexSize = numVertices;
+    }
+
+    if( strokeStripSize < numStrips )
+    {
+        free( strokeFirsts );
+        free( strokeCounts );
+        strokeFirsts = malloc( numStrips * sizeof( GLint ) );
+        strokeCounts = malloc( numStrips * sizeof( GLsizei ) );
+        if( !strokeFirsts || !strokeCounts )
+        {
+            strokeStripSize = 0;
+            fgError( "Failed to allocate memory in fghReserveStrokeString" );
+        }
+        strokeStripSize = numStrips;
+    }
+}
+
+static void fghDrawStrokeStrips( int numStrips )
+{
+    int i;
+
+    if( fgState.HasMultiDraw )
+        fghMultiDrawArrays( GL_LINE_STRIP, strokeFirsts, strokeCounts, numStrips );
+    else
+        for( i = 0; i < numStrips; i++ )
+            glDrawArrays( GL_LINE_STRIP, strokeFirsts[ i ], strokeCounts[ i ] );
+}
+
+/*
+ * Draws length characters of a string, ignoring those the font does not
+ * have. Newlines, if enabled, move the pen back to the start of the line
+ * and down one line, joinDots draws the strips' vertices as points too.
+ *
+ * With the fixed function pipeline, the pen is moved along by translating
+ * the modelview matrix, as GLUT does. Without it (core profiles and
+ * OpenGL ES), the vertices go to the user's glutSetVertexAttribCoord3
+ * attribute instead, and the pen is kept in the context for consecutive
+ * characters: with fromPen, drawing starts where the previous character
+ * ended. Strings start at the origin and put the pen back there, and so do
+ * glutSwapBuffers and glutResetStrokePen.
+ */
+static void fghDrawStrokeString( const SFG_StrokeFont* font, const unsigned char* string, int length,
+                                 GLboolean newlines, GLboolean joinDots, GLboolean fromPen )
+{
+    SFG_Context *context = fgStructure.CurrentWindow ? &fgStructure.CurrentWindow->Window : NULL;
+    const SFG_StrokeArrays *arrays = fghStrokeArrays( font );
+    GLboolean useAttribs = context && fgState.HasOpenGL20 && !fgState.HasFixedPipeline &&
+                           context->attribute_v_coord != -1;
+    float penX = 0.0f, penY = 0.0f;
+    int n, i, numVertices = 0, numStrips = 0;
+    GLfloat *v;
+
+    if( useAttribs && fromPen )
+    {
+        penX = context->StrokePenX;
+        penY = context->StrokePenY;
+    }
+
+    /* Count, then fill in the vertices and strips */
+    for( n = 0; n < length; n++ )
+    {
+        unsigned char c = string[ n ];
+        if( c < font->Quantity && !( c == '\n' && newlines ) )
+        {
+            numVertices += arrays->FirstVertex[ c + 1 ] - arrays->FirstVertex[ c ];
+            numStrips   += arrays->FirstStrip [ c + 1 ] - arrays->FirstStrip [ c ];
+        }
+    }
+    fghReserveStrokeString( numVertices, numStrips );
+
+    for( n = 0, v = strokeVertices, numVertices = 0, numStrips = 0; n < length; n++ )
+    {
+        unsigned char c = string[ n ];
+        const SFG_StrokeChar *schar;
+        const GLfloat *glyph;
+
+        if( c >= font->Quantity )
+            continue;
+        if( c == '\n' && newlines )
+        {
+            penX  = 0.0f;
+            penY -= font->Height;
+            continue;
+        }
+        schar = font->Characters[ c ];
+        if( !schar )
+            continue;
+
+        glyph = arrays->Vertices + 2 * arrays->FirstVertex[ c ];
+        for( i = arrays->FirstVertex[ c ]; i < arrays->FirstVertex[ c + 1 ]; i++ )
+        {
+            *v++ = *glyph++ + penX;
+            *v++ = *glyph++ + penY;
+        }
+        for( i = arrays->FirstStrip[ c ]; i < arrays->FirstStrip[ c + 1 ]; i++ )
+        {
+            strokeFirsts[ numStrips ] = numVertices;
+            strokeCounts[ numStrips ] = arrays->StripCounts[ i ];
+            numVertices += arrays->StripCounts[ i ];
+            numStrips++;
+        }
+        penX += schar->Right;
+    }
+
+    if( useAttribs )
+    {
+        context->StrokePenX = fromPen ? penX : 0.0f;
+        context->StrokePenY = fromPen ? penY : 0.0f;
+        if( !numVertices )
+            return;
+        if( !context->FontBuffer )
+            fghGenBuffers( 1, &context->FontBuffer );
+
+        fghBindBuffer( FGH_ARRAY_BUFFER, context->FontBuffer );
+        fghBufferData( FGH_ARRAY_BUFFER, numVertices * 2 * sizeof( GLfloat ),
+                       strokeVertices, FGH_STREAM_DRAW );
+        fghEnableVertexAttribArray( context->attribute_v_coord );
+        fghVertexAttribPointer( context->attribute_v_coord, 2, GL_FLOAT, GL_FALSE,
+                                0, ( GLvoid * )0 );
+
+        fghDrawStrokeStrips( numStrips );
+        if( joinDots )
+            glDrawArrays( GL_POINTS, 0, numVertices );
+
+        fghDisableVertexAttribArray( context->attribute_v_coord );
+        fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+        return;
+    }
+
+    if( numVertices )
+    {
+        glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+        if( fgState.HasOpenGL20 )
+            fghBindBuffer( FGH_ARRAY_BUFFER, 0 );
+        /* glVertex2f took the current normal, color and texture coordinates */
+        glDisableClientState( GL_NORMAL_ARRAY );
+        glDisableClientState( GL_COLOR_ARRAY );
+        glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+        glEnableClientState( GL_VERTEX_ARRAY );
+        glVertexPointer( 2, GL_FLOAT, 0, strokeVertices );
+
+        fghDrawStrokeStrips( numStrips );
+        if( joinDots )
+            glDrawArrays( GL_POINTS, 0, numVertices );
+
+        glPopClientAttrib( );
+    }
+    glTranslatef( penX, penY, 0.0f );
+}
+
+/*
+ * Releases the flattened stroke fonts and the scratch arrays, for glutExit
+ */
+void fgDestroyStrokeFonts( void )
+{
+    int i;
+
+    for( i = 0; i < FGH_NUM_STROKE_FONTS; i++ )
+    {
+        free( strokeArrays[ i ].Vertices );
+        free( strokeArrays[ i ].StripCounts );
+        free( strokeArrays[ i ].FirstVertex );
+        free( strokeArrays[ i ].FirstStrip );
+        strokeArrays[ i ].Vertices    = NULL;
+        strokeArrays[ i ].StripCounts = NULL;
+        strokeArrays[ i ].FirstVertex = NULL;
+        strokeArrays[ i ].FirstStrip  = NULL;
+    }
+
+    free( strokeVertices );
+    free( strokeFirsts );
+    free( strokeCounts );
+    strokeVertices   = NULL;
+    strokeFirsts     = NULL;
+    strokeCounts     = NULL;
+    strokeVertexSize = 0;
+    strokeStripSize  = 0;
+}
+
 
 /* -- INTERFACE FUNCTIONS -------------------------------------------------- */
 
@@ -109,6 +784,15 @@ void FGAPIENTRY glutBitmapCharacter( void* fontID, int character )
     }
     freeglut_return_if_fail( ( character >= 1 )&&( character < 256 ) );
 
+    if( fgState.BitmapFontAtlas && fgStructure.CurrentWindow )
+    {
+        unsigned char string[ 2 ];
+        string[ 0 ] = ( unsigned char )character;
+        string[ 1 ] = '\0';
+        fghDrawBitmapAtlas( font, string, GL_FALSE );
+        return;
+    }
+
     /*
      * Find the character we want to draw (???)
      */
@@ -145,6 +829,12 @@ void FGAPIENTRY glutBitmapString( void* fontID, const unsigned char *string )
     if ( !string || ! *string )
         return;
 
+    if( fgState.BitmapFontAtlas && fgStructure.CurrentWindow )
+    {
+        fghDrawBitmapAtlas( font, string, GL_TRUE );
+        return;
+    }
+
     glPushClientAttrib( GL_CLIENT_PIXEL_STORE_BIT );
     glPixelStorei( GL_UNPACK_SWAP_BYTES,  GL_FALSE );
     glPixelStorei( GL_UNPACK_LSB_FIRST,   GL_FALSE );
@@ -254,9 +944,7 @@ int FGAPIENTRY glutBitmapHeight( void* fontID )
  */
 void FGAPIENTRY glutStrokeCharacter( void* fontID, int character )
 {
-    const SFG_StrokeChar *schar;
-    const SFG_StrokeStrip *strip;
-    int i, j;
+    unsigned char c;
     SFG_StrokeFont* font;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutStrokeCharacter" );
     font = fghStrokeByID( fontID );
@@ -268,33 +956,14 @@ void FGAPIENTRY glutStrokeCharacter( void* fontID, int character )
     freeglut_return_if_fail( character >= 0 );
     freeglut_return_if_fail( character < font->Quantity );
 
-    schar = font->Characters[ character ];
-    freeglut_return_if_fail( schar );
-    strip = schar->Strips;
+    freeglut_return_if_fail( font->Characters[ character ] );
 
-    for( i = 0; i < schar->Number; i++, strip++ )
-    {
-        glBegin( GL_LINE_STRIP );
-        for( j = 0; j < strip->Number; j++ )
-            glVertex2f( strip->Vertices[ j ].X, strip->Vertices[ j ].Y );
-        glEnd( );
-        
-        if (fgState.StrokeFontDrawJoinDots)
-        {
-            glBegin( GL_POINTS );
-            for( j = 0; j < strip->Number; j++ )
-                glVertex2f( strip->Vertices[ j ].X, strip->Vertices[ j ].Y );
-            glEnd( );
-        }
-    }
-    glTranslatef( schar->Right, 0.0, 0.0 );
+    c = ( unsigned char )character;
+    fghDrawStrokeString( font, &c, 1, GL_FALSE, fgState.StrokeFontDrawJoinDots, GL_TRUE );
 }
 
 void FGAPIENTRY glutStrokeString( void* fontID, const unsigned char *string )
 {
-    unsigned char c;
-    int i, j;
-    float length = 0.0;
     SFG_StrokeFont* font;
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutStrokeString" );
     font = fghStrokeByID( fontID );
@@ -307,40 +976,24 @@ void FGAPIENTRY glutStrokeString( void* fontID, const unsigned char *string )
         return;
 
     /*
-     * Step through the string, drawing each character.
-     * A newline will simply translate the next character's insertion
-     * point back to the start of the line and down one line.
+     * Draw all characters at once. A newline will simply translate the
+     * next character's insertion point back to the start of the line and
+     * down one line.
      */
-    while( ( c = *string++) )
-        if( c < font->Quantity )
-        {
-            if( c == '\n' )
-            {
-                glTranslatef ( -length, -( float )( font->Height ), 0.0 );
-                length = 0.0;
-            }
-            else  /* Not an EOL, draw the bitmap character */
-            {
-                const SFG_StrokeChar *schar = font->Characters[ c ];
-                if( schar )
-                {
-                    const SFG_StrokeStrip *strip = schar->Strips;
-
-                    for( i = 0; i < schar->Number; i++, strip++ )
-                    {
-                        glBegin( GL_LINE_STRIP );
-                        for( j = 0; j < strip->Number; j++ )
-                            glVertex2f( strip->Vertices[ j ].X,
-                                        strip->Vertices[ j ].Y);
-
-                        glEnd( );
-                    }
-
-                    length += schar->Right;
-                    glTranslatef( schar->Right, 0.0, 0.0 );
-                }
-            }
-        }
+    fghDrawStrokeString( font, string, ( int )strlen( ( const char * )string ), GL_TRUE, GL_FALSE, GL_FALSE );
+}
+
+/*
+ * Puts the next stroke character back at the origin, when they are drawn
+ * without the fixed function pipeline, see fghDrawStrokeString
+ */
+void FGAPIENTRY glutResetStrokePen( void )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutResetStrokePen" );
+    FREEGLUT_EXIT_IF_NO_WINDOW ( "glutResetStrokePen" );
+
+    fgStructure.CurrentWindow->Window.StrokePenX = 0.0f;
+    fgStructure.CurrentWindow->Window.StrokePenY = 0.0f;
 }
 
 /*
@@ -31,37 +31,75 @@
 #include <math.h>
 
 /*
- * A note: We do not use the GLuint data type for vertex index arrays
- * in this code as Open GL ES1 only supports GLushort. This affects the
- * cylindrical objects only (Torus, Sphere, Cylinder and Cone) and limits
- * their number of vertices to 65535 (2^16-1). Thats about 256*256
- * subdivisions, which is sufficient for just about any usage case, so
- * I am not going to worry about it for now.
- * One could do compile time detection of the gluint type through CMake,
- * but it is likely that we'll eventually move to runtime selection
- * of OpenGL or GLES1/2, which would make that strategy useless...
+ * A note on vertex indices: the cylindrical objects (Torus, Sphere,
+ * Cylinder and Cone) and the teaset generate their index arrays as GLuint.
+ * When a shape has at most 65536 vertices, which covers all but very
+ * dense tessellations (about 256*256 subdivisions), they are narrowed to
+ * GLushort as that halves their size and is all Open GL ES1/2 support
+ * without the GL_OES_element_index_uint extension. Larger shapes keep
+ * GLuint indices when the context can draw them (fgState.HasUintIndices),
+ * and otherwise get wrapped indices, with a warning. The index type is
+ * passed along with the arrays, the polyhedra always use GLushort.
  */
 
+/* Size in bytes of one vertex in a SFG_GeometryBuffers' interleaved Vbo */
+#define FGH_VERTEX_STRIDE(buffers) ((GLsizei)(((buffers)->HasTextcs ? 8 : 6)*sizeof(GLfloat)))
+
+/* Size in bytes of one vertex index of the given type */
+#define FGH_INDEX_SIZE(idxType) ((idxType)==GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort))
+
 /* declare for drawing using the different OpenGL versions here so we can
    have a nice code order below */
-static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals,
-                                  GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                  GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
+static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals, GLenum idxType,
+                                  GLvoid *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
+                                  GLvoid *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
     );
 static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart);
-static void fghDrawGeometryWire20(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
-                                  GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                  GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2,
+                                   GLenum idxType, GLvoid *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart);
+static void fghDrawGeometryWire20(SFG_GeometryBuffers *buffers,
                                   GLint attribute_v_coord, GLint attribute_v_normal
     );
-static void fghDrawGeometrySolid20(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart,
+static void fghDrawGeometrySolid20(SFG_GeometryBuffers *buffers,
                                    GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture);
+/* declare functions for keeping geometry in (cached) buffer objects */
+static SFG_GeometryBuffers *fghCreateGeometryBuffers(const SFG_GeometryKey *key);
+static void fghUploadGeometry20(SFG_GeometryBuffers *buffers,
+                                GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
+                                GLenum idxType, GLvoid *vertIdxs, GLsizei numVertIdxs,
+                                GLvoid *vertIdxs2, GLsizei numVertIdxs2);
+static void fghDestroyGeometryBuffers(SFG_GeometryBuffers *buffers);
 /* declare function for generating visualization of normals */
 static void fghGenerateNormalVisualization(GLfloat *vertices, GLfloat *normals, GLsizei numVertices);
 static void fghDrawNormalVisualization11();
 static void fghDrawNormalVisualization20(GLint attribute_v_coord);
+/* declare functions for drawing instances */
+static void fghBeginInstance11(GLsizei i);
+static void fghEndInstance11(void);
+static void fghDrawInstances20(SFG_GeometryBuffers *buffers, GLboolean useWireMode);
+/* declare function for drawing a shape's parts with as few calls as possible */
+static void fghDrawParts(GLenum vertexMode, GLsizei numParts, GLsizei numVertPerPart,
+                         GLboolean useIndices, GLenum idxType, const GLvoid *vertIdxs);
+
+/*
+ * Instanced drawing (glutSolidSphereInstanced and friends, see the
+ * interface functions at the end of this file). While such a call is in
+ * progress, numInstances is the number of copies to draw, each with a
+ * column-major 4x4 transform from instanceTransforms and optionally an
+ * RGBA color from instanceColors.
+ *   - OpenGL (ES) 1.1: each copy is drawn separately, with its transform
+ *     multiplied onto the modelview matrix and its color set as current
+ *     color.
+ *   - OpenGL (ES) >= 2.0: the transform goes to the four attributes
+ *     starting at glutSetVertexAttribInstanceMatrix and the color to
+ *     glutSetVertexAttribInstanceColor. With OpenGL 3.3/ES 3.0 all copies
+ *     are drawn by a single instanced draw per part, else each copy is
+ *     drawn separately with the attributes set as constants.
+ * Normals are not visualized (GLUT_GEOMETRY_VISUALIZE_NORMALS) when
+ * drawing instances.
+ */
+static GLsizei        numInstances = 0;
+static const GLfloat *instanceTransforms = NULL;
+static const GLfloat *instanceColors = NULL;
 
 /* Drawing geometry:
  * Explanation of the functions has to be separate for the polyhedra and
@@ -78,7 +116,8 @@ static void fghDrawNormalVisualization20(GLint attribute_v_coord);
  *   - WireFrame drawing is done using a GL_LINE_LOOP per face, and thus
  *     issuing one draw call per face. glDrawArrays is always used as no
  *     triangle decomposition is needed to draw faces. We use the "first"
- *     parameter in glDrawArrays to go from face to face.
+ *     parameter in glDrawArrays to go from face to face. When available,
+ *     all faces are drawn with a single glMultiDrawArrays call instead.
  * 
  * Non-polyhedra:
  *   - We have implemented the sphere, cylinder, cone and torus.
@@ -94,11 +133,25 @@ static void fghDrawNormalVisualization20(GLint attribute_v_coord);
  *   - WireFrame drawing is done for the subdivisions along the two axes 
  *     separately, usually using GL_LINE_LOOP. Vertex index arrays are
  *     built containing the vertices to be drawn for each loop, which are
- *     then drawn using multiple calls to glDrawElements. As the number of
+ *     then drawn using multiple calls to glDrawElements (or one call to
+ *     glMultiDrawElements when available). As the number of
  *     subdivisions along the two axes is not guaranteed to be equal, the
  *     vertex indices for e.g. stacks and slices are stored in separate
  *     arrays, which makes the input to the drawing function a bit clunky,
  *     but allows for the same drawing function to be used for all shapes.
+ *
+ * Buffer caching (OpenGL (ES) >= 2.0 only):
+ *   - When drawing with vertex attributes, the generated arrays are
+ *     uploaded to buffer objects. Every shape is identified by a
+ *     SFG_GeometryKey (shape, parameters, wire or solid), and its buffers
+ *     are kept in a per-context list (most recently used first) of at
+ *     most FREEGLUT_GEOMETRY_CACHE_SIZE entries. A shape found in that
+ *     list is drawn straight from its buffers, skipping generation and
+ *     upload altogether. The least recently used shape is evicted when
+ *     the list is full, and all are released when the window is
+ *     destroyed (fgDestroyGeometryCache).
+ *   - Callers that can't describe their geometry with a key pass NULL,
+ *     and get buffers that are deleted again right after the draw.
  */
 
 
@@ -106,10 +159,15 @@ static void fghDrawNormalVisualization20(GLint attribute_v_coord);
  * Draw geometric shape in wire mode (only edges)
  *
  * Arguments:
+ * const SFG_GeometryKey *key
+ *   identifies the shape for the buffer cache, NULL to not cache it
  * GLfloat *vertices, GLfloat *normals, GLsizei numVertices
  *   The vertex coordinate and normal buffers, and the number of entries in
  *   those
- * GLushort *vertIdxs
+ * GLenum idxType
+ *   GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, the type of both vertex index
+ *   buffers
+ * GLvoid *vertIdxs
  *   a vertex indices buffer, optional (never passed for the polyhedra)
  * GLsizei numParts, GLsizei numVertPerPart
  *   polyhedra: number of faces, and the number of vertices for drawing
@@ -123,39 +181,66 @@ static void fghDrawNormalVisualization20(GLint attribute_v_coord);
  * GLenum vertexMode
  *   vertex drawing mode (e.g. always GL_LINE_LOOP for polyhedra, varies
  *   for others)
- * GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
+ * GLvoid *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
  *   non-polyhedra only: same as the above, but now for subdivisions along
  *   the other axis. Always drawn as GL_LINE_LOOP.
  *
  * Feel free to contribute better naming ;)
  */
-void fghDrawGeometryWire(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
-                                GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
+void fghDrawGeometryWire(const SFG_GeometryKey *key,
+                         GLfloat *vertices, GLfloat *normals, GLsizei numVertices, GLenum idxType,
+                         GLvoid *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
+                         GLvoid *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
     )
 {
     GLint attribute_v_coord  = fgStructure.CurrentWindow->Window.attribute_v_coord;
     GLint attribute_v_normal = fgStructure.CurrentWindow->Window.attribute_v_normal;
 
     if (fgState.HasOpenGL20 && (attribute_v_coord != -1 || attribute_v_normal != -1))
+    {
         /* User requested a 2.0 draw */
-        fghDrawGeometryWire20(vertices, normals, numVertices,
-                              vertIdxs, numParts, numVertPerPart, vertexMode,
-                              vertIdxs2, numParts2, numVertPerPart2,
-                              attribute_v_coord, attribute_v_normal);
+        SFG_GeometryBuffers *buffers = fghCreateGeometryBuffers(key);
+
+        fghUploadGeometry20(buffers, vertices, normals, NULL, numVertices,
+                            idxType, vertIdxs, numParts*numVertPerPart,
+                            vertIdxs2, numParts2*numVertPerPart2);
+        buffers->NumParts        = numParts;
+        buffers->NumVertPerPart  = numVertPerPart;
+        buffers->VertexMode      = vertexMode;
+        buffers->NumParts2       = numParts2;
+        buffers->NumVertPerPart2 = numVertPerPart2;
+
+        fghDrawGeometryWire20(buffers, attribute_v_coord, attribute_v_normal);
+
+        if (!key)
+            /* not cached, done with these buffers */
+            fghDestroyGeometryBuffers(buffers);
+    }
     else
-        fghDrawGeometryWire11(vertices, normals,
-                              vertIdxs, numParts, numVertPerPart, vertexMode,
-                              vertIdxs2, numParts2, numVertPerPart2);
+    {
+        GLsizei i = 0;
+        do
+        {
+            fghBeginInstance11(i);
+            fghDrawGeometryWire11(vertices, normals, idxType,
+                                  vertIdxs, numParts, numVertPerPart, vertexMode,
+                                  vertIdxs2, numParts2, numVertPerPart2);
+            fghEndInstance11();
+        } while (++i < numInstances);
+    }
 }
 
 /* Draw the geometric shape with filled triangles
  *
  * Arguments:
+ * const SFG_GeometryKey *key
+ *   identifies the shape for the buffer cache, NULL to not cache it
  * GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices
  *   The vertex coordinate, normal and texture coordinate buffers, and the
  *   number of entries in those
- * GLushort *vertIdxs
+ * GLenum idxType
+ *   GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, the type of vertIdxs
+ * GLvoid *vertIdxs
  *   a vertex indices buffer, optional (not passed for the polyhedra with
  *   triangular faces)
  * GLsizei numParts, GLsizei numVertPerPart
@@ -175,49 +260,205 @@ void fghDrawGeometryWire(GLfloat *vertices, GLfloat *normals, GLsizei numVertice
  *   numParts * numVertPerPart gives the number of entries in the vertex
  *     array vertIdxs
  */
-void fghDrawGeometrySolid(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                          GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart)
+void fghDrawGeometrySolid(const SFG_GeometryKey *key,
+                          GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
+                          GLenum idxType, GLvoid *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart)
 {
     GLint attribute_v_coord   = fgStructure.CurrentWindow->Window.attribute_v_coord;
     GLint attribute_v_normal  = fgStructure.CurrentWindow->Window.attribute_v_normal;
     GLint attribute_v_texture = fgStructure.CurrentWindow->Window.attribute_v_texture;
 
-    if (fgStructure.CurrentWindow->State.VisualizeNormals)
+    GLboolean visualizeNormals = fgStructure.CurrentWindow->State.VisualizeNormals && !numInstances;
+
+    if (visualizeNormals)
+    {
         /* generate normals for each vertex to be drawn as well */
         fghGenerateNormalVisualization(vertices, normals, numVertices);
+        /* fghDrawCachedGeometry doesn't look such draws up, so caching
+         * them would only add duplicates of the shape to the cache */
+        key = NULL;
+    }
 
     if (fgState.HasOpenGL20 && (attribute_v_coord != -1 || attribute_v_normal != -1))
     {
         /* User requested a 2.0 draw */
-        fghDrawGeometrySolid20(vertices, normals, textcs, numVertices,
-                               vertIdxs, numParts, numVertIdxsPerPart,
+        SFG_GeometryBuffers *buffers = fghCreateGeometryBuffers(key);
+
+        fghUploadGeometry20(buffers, vertices, normals, textcs, numVertices,
+                            idxType, vertIdxs, numParts*numVertIdxsPerPart,
+                            NULL, 0);
+        buffers->NumParts        = numParts;
+        buffers->NumVertPerPart  = numVertIdxsPerPart;
+
+        fghDrawGeometrySolid20(buffers,
                                attribute_v_coord, attribute_v_normal, attribute_v_texture);
 
-        if (fgStructure.CurrentWindow->State.VisualizeNormals)
+        if (!key)
+            /* not cached, done with these buffers */
+            fghDestroyGeometryBuffers(buffers);
+
+        if (visualizeNormals)
             /* draw normals for each vertex as well */
             fghDrawNormalVisualization20(attribute_v_coord);
     }
     else
     {
-        fghDrawGeometrySolid11(vertices, normals, textcs, numVertices,
-                               vertIdxs, numParts, numVertIdxsPerPart);
+        GLsizei i = 0;
+        do
+        {
+            fghBeginInstance11(i);
+            fghDrawGeometrySolid11(vertices, normals, textcs, numVertices,
+                                   idxType, vertIdxs, numParts, numVertIdxsPerPart);
+            fghEndInstance11();
+        } while (++i < numInstances);
 
-        if (fgStructure.CurrentWindow->State.VisualizeNormals)
+        if (visualizeNormals)
             /* draw normals for each vertex as well */
             fghDrawNormalVisualization11();
     }
 }
 
+/*
+ * Looks up the shape identified by key in the current context's buffer
+ * cache and draws it from there. Returns GL_FALSE if the shape is not
+ * cached or can't be drawn from the cache, in which case the caller has to
+ * generate the shape and draw it with fghDrawGeometryWire/Solid (which
+ * will add it to the cache).
+ */
+GLboolean fghDrawCachedGeometry(const SFG_GeometryKey *key)
+{
+    SFG_Context *context = &fgStructure.CurrentWindow->Window;
+    SFG_GeometryBuffers *buffers;
+
+    if (!fgState.HasOpenGL20 || (context->attribute_v_coord == -1 && context->attribute_v_normal == -1))
+        /* 1.1 draws don't use buffer objects */
+        return GL_FALSE;
+    if (!key->Wire && fgStructure.CurrentWindow->State.VisualizeNormals && !numInstances)
+        /* normal visualization needs the vertices and normals in client memory */
+        return GL_FALSE;
+
+    for( buffers = ( SFG_GeometryBuffers * )context->GeometryCache.First;
+         buffers;
+         buffers = ( SFG_GeometryBuffers * )buffers->Node.Next )
+    {
+        if( buffers->Key.Shape     == key->Shape     &&
+            buffers->Key.Wire      == key->Wire      &&
+            buffers->Key.Params[0] == key->Params[0] &&
+            buffers->Key.Params[1] == key->Params[1] &&
+            buffers->Key.Params[2] == key->Params[2] &&
+            buffers->Key.Params[3] == key->Params[3] &&
+            buffers->Key.Params[4] == key->Params[4] )
+            break;
+    }
+    if (!buffers)
+        return GL_FALSE;
+
+    /* Move to front of list, so the least recently used shape is always last */
+    if (buffers != context->GeometryCache.First)
+    {
+        fgListRemove(&context->GeometryCache, &buffers->Node);
+        fgListInsert(&context->GeometryCache, context->GeometryCache.First, &buffers->Node);
+    }
+
+    if (key->Wire)
+        fghDrawGeometryWire20(buffers, context->attribute_v_coord, context->attribute_v_normal);
+    else
+        fghDrawGeometrySolid20(buffers, context->attribute_v_coord, context->attribute_v_normal, context->attribute_v_texture);
+
+    return GL_TRUE;
+}
+
+/*
+ * Fill in a key identifying a shape, unused parameters should be passed
+ * as 0
+ */
+void fghInitGeometryKey(SFG_GeometryKey *key, fgShape shape, GLboolean useWireMode,
+                        double param0, double param1, double param2, double param3, double param4)
+{
+    key->Shape     = shape;
+    key->Wire      = useWireMode;
+    key->Params[0] = param0;
+    key->Params[1] = param1;
+    key->Params[2] = param2;
+    key->Params[3] = param3;
+    key->Params[4] = param4;
+}
+
+
+
+/*
+ * Draw numParts consecutive runs of numVertPerPart vertices, or of vertex
+ * indices of type idxType if useIndices (vertIdxs is then a client array,
+ * or NULL when drawing from the bound element array buffer). Uses a single
+ * glMultiDrawArrays/Elements call when available.
+ */
+static GLint         *multiDrawFirsts  = NULL;
+static GLsizei       *multiDrawCounts  = NULL;
+static const GLvoid **multiDrawIndices = NULL;
+static GLsizei        multiDrawSize    = 0;
+
+static void fghDrawParts(GLenum vertexMode, GLsizei numParts, GLsizei numVertPerPart,
+                         GLboolean useIndices, GLenum idxType, const GLvoid *vertIdxs)
+{
+    const char *idxBase = (const char *)vertIdxs;
+    const size_t idxSize = FGH_INDEX_SIZE(idxType);
+    int i;
+
+    if (fgState.HasMultiDraw && numParts>1 && multiDrawSize<numParts)
+    {
+        free(multiDrawFirsts);
+        free(multiDrawCounts);
+        free(multiDrawIndices);
+        multiDrawFirsts  = malloc(numParts*sizeof(GLint));
+        multiDrawCounts  = malloc(numParts*sizeof(GLsizei));
+        multiDrawIndices = malloc(numParts*sizeof(GLvoid*));
+        if (!multiDrawFirsts || !multiDrawCounts || !multiDrawIndices)
+            fgError("Failed to allocate memory in fghDrawParts");
+        multiDrawSize = numParts;
+    }
+
+    if (fgState.HasMultiDraw && numParts>1)
+    {
+        for (i=0; i<numParts; i++)
+        {
+            multiDrawFirsts [i] = i*numVertPerPart;
+            multiDrawCounts [i] = numVertPerPart;
+            multiDrawIndices[i] = idxBase + idxSize*i*numVertPerPart;
+        }
 
+        if (useIndices)
+            fghMultiDrawElements(vertexMode, multiDrawCounts, idxType, multiDrawIndices, numParts);
+        else
+            fghMultiDrawArrays(vertexMode, multiDrawFirsts, multiDrawCounts, numParts);
+    }
+    else
+    {
+        for (i=0; i<numParts; i++)
+            if (useIndices)
+                glDrawElements(vertexMode, numVertPerPart, idxType, idxBase + idxSize*i*numVertPerPart);
+            else
+                glDrawArrays(vertexMode, i*numVertPerPart, numVertPerPart);
+    }
+}
+
+/* Release the scratch arrays used by fghDrawParts */
+static void fghDestroyMultiDrawArrays( void )
+{
+    free(multiDrawFirsts);
+    free(multiDrawCounts);
+    free(multiDrawIndices);
+    multiDrawFirsts  = NULL;
+    multiDrawCounts  = NULL;
+    multiDrawIndices = NULL;
+    multiDrawSize    = 0;
+}
 
 /* Version for OpenGL (ES) 1.1 */
-static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals,
-                                  GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                  GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
+static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals, GLenum idxType,
+                                  GLvoid *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
+                                  GLvoid *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2
     )
 {
-    int i;
-    
     glEnableClientState(GL_VERTEX_ARRAY);
     glEnableClientState(GL_NORMAL_ARRAY);
 
@@ -225,17 +466,11 @@ static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals,
     glNormalPointer(GL_FLOAT, 0, normals);
 
     
-    if (!vertIdxs)
-        /* Draw per face (TODO: could use glMultiDrawArrays if available) */
-        for (i=0; i<numParts; i++)
-            glDrawArrays(vertexMode, i*numVertPerPart, numVertPerPart);
-    else
-        for (i=0; i<numParts; i++)
-            glDrawElements(vertexMode,numVertPerPart,GL_UNSIGNED_SHORT,vertIdxs+i*numVertPerPart);
+    /* Draw per face or subdivision */
+    fghDrawParts(vertexMode, numParts, numVertPerPart, vertIdxs!=NULL, idxType, vertIdxs);
 
     if (vertIdxs2)
-        for (i=0; i<numParts2; i++)
-            glDrawElements(GL_LINE_LOOP,numVertPerPart2,GL_UNSIGNED_SHORT,vertIdxs2+i*numVertPerPart2);
+        fghDrawParts(GL_LINE_LOOP, numParts2, numVertPerPart2, GL_TRUE, idxType, vertIdxs2);
 
     glDisableClientState(GL_VERTEX_ARRAY);
     glDisableClientState(GL_NORMAL_ARRAY);
@@ -243,8 +478,9 @@ static void fghDrawGeometryWire11(GLfloat *vertices, GLfloat *normals,
 
 
 static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart)
+                                   GLenum idxType, GLvoid *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart)
 {
+    const char *idxBase = (const char *)vertIdxs;
     int i;
 
     glEnableClientState(GL_VERTEX_ARRAY);
@@ -264,9 +500,9 @@ static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat
     else
         if (numParts>1)
             for (i=0; i<numParts; i++)
-                glDrawElements(GL_TRIANGLE_STRIP, numVertIdxsPerPart, GL_UNSIGNED_SHORT, vertIdxs+i*numVertIdxsPerPart);
+                glDrawElements(GL_TRIANGLE_STRIP, numVertIdxsPerPart, idxType, idxBase + FGH_INDEX_SIZE(idxType)*i*numVertIdxsPerPart);
         else
-            glDrawElements(GL_TRIANGLES, numVertIdxsPerPart, GL_UNSIGNED_SHORT, vertIdxs);
+            glDrawElements(GL_TRIANGLES, numVertIdxsPerPart, idxType, vertIdxs);
 
     glDisableClientState(GL_VERTEX_ARRAY);
     glDisableClientState(GL_NORMAL_ARRAY);
@@ -274,232 +510,435 @@ static void fghDrawGeometrySolid11(GLfloat *vertices, GLfloat *normals, GLfloat
         glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 }
 
-/* Version for OpenGL (ES) >= 2.0 */
-static void fghDrawGeometryWire20(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
-                                  GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                  GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2,
-                                  GLint attribute_v_coord, GLint attribute_v_normal)
+/*
+ * Get a new set of buffers. If a key is passed, they are added to the
+ * front of the current context's cache, evicting the least recently used
+ * shape if the cache is full. Without key, the caller has to free them
+ * with fghDestroyGeometryBuffers.
+ */
+static SFG_GeometryBuffers *fghCreateGeometryBuffers(const SFG_GeometryKey *key)
 {
-    GLuint vbo_coords = 0, vbo_normals = 0,
-        ibo_elements = 0, ibo_elements2 = 0;
-    GLsizei numVertIdxs = numParts * numVertPerPart;
-    GLsizei numVertIdxs2 = numParts2 * numVertPerPart2;
-    int i;
+    SFG_Context *context = &fgStructure.CurrentWindow->Window;
+    SFG_GeometryBuffers *buffers = calloc(1, sizeof(SFG_GeometryBuffers));
 
-    if (numVertices > 0 && attribute_v_coord != -1) {
-        fghGenBuffers(1, &vbo_coords);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(vertices[0]),
-                      vertices, FGH_STATIC_DRAW);
+    /* Bail out if memory allocation fails, fgError never returns */
+    if (!buffers)
+        fgError("Failed to allocate memory in fghCreateGeometryBuffers");
+
+    if (key)
+    {
+        buffers->Key = *key;
+
+        if (context->GeometryCacheSize >= FREEGLUT_GEOMETRY_CACHE_SIZE)
+        {
+            SFG_GeometryBuffers *oldest = context->GeometryCache.Last;
+            fgListRemove(&context->GeometryCache, &oldest->Node);
+            fghDestroyGeometryBuffers(oldest);
+            context->GeometryCacheSize--;
+        }
+
+        fgListInsert(&context->GeometryCache, context->GeometryCache.First, &buffers->Node);
+        context->GeometryCacheSize++;
     }
-    
-    if (numVertices > 0 && attribute_v_normal != -1) {
-        fghGenBuffers(1, &vbo_normals);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(normals[0]),
-                      normals, FGH_STATIC_DRAW);
+
+    return buffers;
+}
+
+/*
+ * Version for OpenGL (ES) >= 2.0. The vertex coordinates, normals and
+ * texture coordinates (if any) go into a single buffer, interleaved per
+ * vertex as x,y,z,nx,ny,nz[,s,t], so a vertex is fetched from one place
+ * and one buffer binding serves all attributes.
+ */
+static void fghUploadGeometry20(SFG_GeometryBuffers *buffers,
+                                GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
+                                GLenum idxType, GLvoid *vertIdxs, GLsizei numVertIdxs,
+                                GLvoid *vertIdxs2, GLsizei numVertIdxs2)
+{
+    /* Upload everything we have, so the buffers can be drawn later on
+     * whatever set of attributes is in use at that time.
+     */
+    buffers->NumVertices = numVertices;
+    buffers->IdxType     = idxType;
+    buffers->HasTextcs   = textcs != NULL;
+
+    if (numVertices > 0) {
+        GLsizei stride = FGH_VERTEX_STRIDE(buffers);
+        GLfloat *interleaved = malloc(numVertices * stride);
+        GLfloat *v;
+        GLsizei i;
+
+        /* Bail out if memory allocation fails, fgError never returns */
+        if (!interleaved)
+            fgError("Failed to allocate memory in fghUploadGeometry20");
+
+        for (i=0, v=interleaved; i<numVertices; i++)
+        {
+            *v++ = vertices[3*i  ];
+            *v++ = vertices[3*i+1];
+            *v++ = vertices[3*i+2];
+            *v++ = normals [3*i  ];
+            *v++ = normals [3*i+1];
+            *v++ = normals [3*i+2];
+            if (textcs)
+            {
+                *v++ = textcs[2*i  ];
+                *v++ = textcs[2*i+1];
+            }
+        }
+
+        fghGenBuffers(1, &buffers->Vbo);
+        fghBindBuffer(FGH_ARRAY_BUFFER, buffers->Vbo);
+        fghBufferData(FGH_ARRAY_BUFFER, numVertices * stride,
+                      interleaved, FGH_STATIC_DRAW);
+        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+
+        free(interleaved);
     }
     
     if (vertIdxs != NULL) {
-        fghGenBuffers(1, &ibo_elements);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs * sizeof(vertIdxs[0]),
+        fghGenBuffers(1, &buffers->IboElements);
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, buffers->IboElements);
+        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs * FGH_INDEX_SIZE(idxType),
                       vertIdxs, FGH_STATIC_DRAW);
         fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
     }
 
     if (vertIdxs2 != NULL) {
-        fghGenBuffers(1, &ibo_elements2);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements2);
-        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs2 * sizeof(vertIdxs2[0]),
+        fghGenBuffers(1, &buffers->IboElements2);
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, buffers->IboElements2);
+        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs2 * FGH_INDEX_SIZE(idxType),
                       vertIdxs2, FGH_STATIC_DRAW);
         fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
     }
+}
 
-    if (vbo_coords) {
-        fghEnableVertexAttribArray(attribute_v_coord);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
-        fghVertexAttribPointer(
-            attribute_v_coord,  /* attribute */
-            3,                  /* number of elements per vertex, here (x,y,z) */
-            GL_FLOAT,           /* the type of each element */
-            GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
-        );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+static void fghDestroyGeometryBuffers(SFG_GeometryBuffers *buffers)
+{
+    if (buffers->Vbo != 0)
+        fghDeleteBuffers(1, &buffers->Vbo);
+    if (buffers->IboElements != 0)
+        fghDeleteBuffers(1, &buffers->IboElements);
+    if (buffers->IboElements2 != 0)
+        fghDeleteBuffers(1, &buffers->IboElements2);
+
+    free(buffers);
+}
+
+/*
+ * Release all buffers cached for a window's context, and those used for
+ * instanced drawing. Makes the window current, the caller is responsible
+ * for restoring the current window.
+ */
+void fgDestroyGeometryCache( SFG_Window *window )
+{
+    SFG_Context *context = &window->Window;
+
+    if (!context->GeometryCache.First && !context->InstanceBuffers[0])
+        return;
+
+    fgSetWindow(window);
+    while (context->GeometryCache.First)
+    {
+        SFG_GeometryBuffers *buffers = context->GeometryCache.First;
+        fgListRemove(&context->GeometryCache, &buffers->Node);
+        fghDestroyGeometryBuffers(buffers);
     }
+    context->GeometryCacheSize = 0;
 
-    if (vbo_normals) {
-        fghEnableVertexAttribArray(attribute_v_normal);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
-        fghVertexAttribPointer(
-            attribute_v_normal, /* attribute */
-            3,                  /* number of elements per vertex, here (x,y,z) */
-            GL_FLOAT,           /* the type of each element */
-            GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
-        );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+    if (context->InstanceBuffers[0])
+    {
+        fghDeleteBuffers(2, context->InstanceBuffers);
+        context->InstanceBuffers[0] = context->InstanceBuffers[1] = 0;
     }
+}
 
-    if (!vertIdxs) {
-        /* Draw per face (TODO: could use glMultiDrawArrays if available) */
-        for (i=0; i<numParts; i++)
-            glDrawArrays(vertexMode, i*numVertPerPart, numVertPerPart);
+static GLboolean fghBeginInstances(GLsizei count, const GLfloat *transforms, const GLfloat *colors)
+{
+    if (count<=0 || !transforms)
+        /* nothing to draw */
+        return GL_FALSE;
+
+    numInstances       = count;
+    instanceTransforms = transforms;
+    instanceColors     = colors;
+    return GL_TRUE;
+}
+
+static void fghEndInstances(void)
+{
+    numInstances       = 0;
+    instanceTransforms = NULL;
+    instanceColors     = NULL;
+}
+
+/* Version for OpenGL (ES) 1.1, called around drawing copy i */
+static void fghBeginInstance11(GLsizei i)
+{
+    if (!numInstances)
+        return;
+
+    glPushMatrix();
+    glMultMatrixf(instanceTransforms+16*i);
+    if (instanceColors)
+        glColor4f(instanceColors[4*i],instanceColors[4*i+1],instanceColors[4*i+2],instanceColors[4*i+3]);
+}
+
+static void fghEndInstance11(void)
+{
+    if (numInstances)
+        glPopMatrix();
+}
+
+/* Draw calls for OpenGL (ES) >= 2.0, instanced if instances > 0 */
+static void fghDrawArrays20(GLsizei instances, GLenum mode, GLint first, GLsizei count)
+{
+    if (instances)
+        fghDrawArraysInstanced(mode, first, count, instances);
+    else
+        glDrawArrays(mode, first, count);
+}
+
+static void fghDrawElements20(GLsizei instances, GLenum mode, GLsizei count, GLenum type, const GLvoid *indices)
+{
+    if (instances)
+        fghDrawElementsInstanced(mode, count, type, indices, instances);
+    else
+        glDrawElements(mode, count, type, indices);
+}
+
+static void fghDrawWireParts20(SFG_GeometryBuffers *buffers, GLsizei instances)
+{
+    int i;
+
+    if (!buffers->IboElements) {
+        /* Draw per face */
+        if (!instances)
+            fghDrawParts(buffers->VertexMode, buffers->NumParts, buffers->NumVertPerPart, GL_FALSE, buffers->IdxType, NULL);
+        else
+            for (i=0; i<buffers->NumParts; i++)
+                fghDrawArrays20(instances, buffers->VertexMode, i*buffers->NumVertPerPart, buffers->NumVertPerPart);
     } else {
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        for (i=0; i<numParts; i++)
-            glDrawElements(vertexMode, numVertPerPart,
-                           GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(vertIdxs[0])*i*numVertPerPart));
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, buffers->IboElements);
+        if (!instances)
+            fghDrawParts(buffers->VertexMode, buffers->NumParts, buffers->NumVertPerPart, GL_TRUE, buffers->IdxType, NULL);
+        else
+            for (i=0; i<buffers->NumParts; i++)
+                fghDrawElements20(instances, buffers->VertexMode, buffers->NumVertPerPart,
+                                  buffers->IdxType, (GLvoid*)(FGH_INDEX_SIZE(buffers->IdxType)*i*buffers->NumVertPerPart));
         /* Clean existing bindings before clean-up */
         /* Android showed instability otherwise */
         fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
     }
 
-    if (vertIdxs2) {
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements2);
-        for (i=0; i<numParts2; i++)
-            glDrawElements(GL_LINE_LOOP, numVertPerPart2,
-                           GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(vertIdxs2[0])*i*numVertPerPart2));
+    if (buffers->IboElements2) {
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, buffers->IboElements2);
+        if (!instances)
+            fghDrawParts(GL_LINE_LOOP, buffers->NumParts2, buffers->NumVertPerPart2, GL_TRUE, buffers->IdxType, NULL);
+        else
+            for (i=0; i<buffers->NumParts2; i++)
+                fghDrawElements20(instances, GL_LINE_LOOP, buffers->NumVertPerPart2,
+                                  buffers->IdxType, (GLvoid*)(FGH_INDEX_SIZE(buffers->IdxType)*i*buffers->NumVertPerPart2));
         /* Clean existing bindings before clean-up */
         /* Android showed instability otherwise */
         fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
     }
-    
-    if (vbo_coords != 0)
-        fghDisableVertexAttribArray(attribute_v_coord);
-    if (vbo_normals != 0)
-        fghDisableVertexAttribArray(attribute_v_normal);
-    
-    if (vbo_coords != 0)
-        fghDeleteBuffers(1, &vbo_coords);
-    if (vbo_normals != 0)
-        fghDeleteBuffers(1, &vbo_normals);
-    if (ibo_elements != 0)
-        fghDeleteBuffers(1, &ibo_elements);
-    if (ibo_elements2 != 0)
-        fghDeleteBuffers(1, &ibo_elements2);
 }
 
+static void fghDrawSolidParts20(SFG_GeometryBuffers *buffers, GLsizei instances)
+{
+    int i;
 
+    if (!buffers->IboElements) {
+        fghDrawArrays20(instances, GL_TRIANGLES, 0, buffers->NumVertices);
+    } else {
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, buffers->IboElements);
+        if (buffers->NumParts>1) {
+            for (i=0; i<buffers->NumParts; i++) {
+                fghDrawElements20(instances, GL_TRIANGLE_STRIP, buffers->NumVertPerPart, buffers->IdxType, (GLvoid*)(FGH_INDEX_SIZE(buffers->IdxType)*i*buffers->NumVertPerPart));
+            }
+        } else {
+            fghDrawElements20(instances, GL_TRIANGLES, buffers->NumVertPerPart, buffers->IdxType, 0);
+        }
+        /* Clean existing bindings before clean-up */
+        /* Android showed instability otherwise */
+        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
+    }
+}
 
-
-/* Version for OpenGL (ES) >= 2.0 */
-static void fghDrawGeometrySolid20(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                                   GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart,
-                                   GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture)
+/*
+ * Issue the draw calls for a shape whose vertex attributes are set up,
+ * once, or for all instances when drawing instances
+ */
+static void fghDrawInstances20(SFG_GeometryBuffers *buffers, GLboolean useWireMode)
 {
-    GLuint vbo_coords = 0, vbo_normals = 0, vbo_textcs = 0, ibo_elements = 0;
-    GLsizei numVertIdxs = numParts * numVertIdxsPerPart;
-    int i;
-  
-    if (numVertices > 0 && attribute_v_coord != -1) {
-        fghGenBuffers(1, &vbo_coords);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(vertices[0]),
-                      vertices, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+    SFG_Context *context = &fgStructure.CurrentWindow->Window;
+    GLint attribute_i_matrix = context->attribute_i_matrix;
+    GLint attribute_i_color  = instanceColors ? context->attribute_i_color : -1;
+    GLsizei i;
+    int c;
+
+    if (!numInstances)
+    {
+        if (useWireMode)
+            fghDrawWireParts20(buffers, 0);
+        else
+            fghDrawSolidParts20(buffers, 0);
+        return;
     }
-    
-    if (numVertices > 0 && attribute_v_normal != -1) {
-        fghGenBuffers(1, &vbo_normals);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 3 * sizeof(normals[0]),
-                      normals, FGH_STATIC_DRAW);
+
+    if (fgState.HasInstancing && attribute_i_matrix != -1)
+    {
+        /* upload transforms and colors, and have them advance per instance */
+        if (!context->InstanceBuffers[0])
+            fghGenBuffers(2, context->InstanceBuffers);
+
+        fghBindBuffer(FGH_ARRAY_BUFFER, context->InstanceBuffers[0]);
+        fghBufferData(FGH_ARRAY_BUFFER, numInstances * 16 * sizeof(GLfloat), instanceTransforms, FGH_STREAM_DRAW);
+        for (c=0; c<4; c++)
+        {
+            fghEnableVertexAttribArray(attribute_i_matrix+c);
+            fghVertexAttribPointer(attribute_i_matrix+c, 4, GL_FLOAT, GL_FALSE,
+                                   16*sizeof(GLfloat), (GLvoid*)(4*c*sizeof(GLfloat)));
+            fghVertexAttribDivisor(attribute_i_matrix+c, 1);
+        }
+
+        if (attribute_i_color != -1)
+        {
+            fghBindBuffer(FGH_ARRAY_BUFFER, context->InstanceBuffers[1]);
+            fghBufferData(FGH_ARRAY_BUFFER, numInstances * 4 * sizeof(GLfloat), instanceColors, FGH_STREAM_DRAW);
+            fghEnableVertexAttribArray(attribute_i_color);
+            fghVertexAttribPointer(attribute_i_color, 4, GL_FLOAT, GL_FALSE, 0, 0);
+            fghVertexAttribDivisor(attribute_i_color, 1);
+        }
         fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+
+        if (useWireMode)
+            fghDrawWireParts20(buffers, numInstances);
+        else
+            fghDrawSolidParts20(buffers, numInstances);
+
+        /* reset divisors, these attribute indices may be used without instancing */
+        for (c=0; c<4; c++)
+        {
+            fghVertexAttribDivisor(attribute_i_matrix+c, 0);
+            fghDisableVertexAttribArray(attribute_i_matrix+c);
+        }
+        if (attribute_i_color != -1)
+        {
+            fghVertexAttribDivisor(attribute_i_color, 0);
+            fghDisableVertexAttribArray(attribute_i_color);
+        }
+        return;
     }
 
-    if (numVertices > 0 && attribute_v_texture != -1 && textcs) {
-        fghGenBuffers(1, &vbo_textcs);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_textcs);
-        fghBufferData(FGH_ARRAY_BUFFER, numVertices * 2 * sizeof(textcs[0]),
-                      textcs, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+    if (attribute_i_matrix == -1 && !fgState.HasFixedPipeline)
+    {
+        /* nowhere to put the transforms, all copies would end up on top of each other */
+        fgWarning("Instanced shape not drawn: no glutSetVertexAttribInstanceMatrix attribute, and no fixed function pipeline");
+        return;
     }
-    
-    if (vertIdxs != NULL) {
-        fghGenBuffers(1, &ibo_elements);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        fghBufferData(FGH_ELEMENT_ARRAY_BUFFER, numVertIdxs * sizeof(vertIdxs[0]),
-                      vertIdxs, FGH_STATIC_DRAW);
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
+
+    /* No instanced drawing, draw copies one by one with constant attributes,
+     * or with their transform on the modelview matrix as for OpenGL 1.1 */
+    for (i=0; i<numInstances; i++)
+    {
+        if (attribute_i_matrix != -1)
+            for (c=0; c<4; c++)
+                fghVertexAttrib4fv(attribute_i_matrix+c, instanceTransforms+16*i+4*c);
+        else
+        {
+            glPushMatrix();
+            glMultMatrixf(instanceTransforms+16*i);
+        }
+        if (attribute_i_color != -1)
+            fghVertexAttrib4fv(attribute_i_color, instanceColors+4*i);
+
+        if (useWireMode)
+            fghDrawWireParts20(buffers, 0);
+        else
+            fghDrawSolidParts20(buffers, 0);
+
+        if (attribute_i_matrix == -1)
+            glPopMatrix();
     }
-    
-    if (vbo_coords) {
+}
+
+/* Version for OpenGL (ES) >= 2.0 */
+/*
+ * Point the requested attributes at their part of the interleaved vertex
+ * buffer (attributes that are -1 are skipped), draw, and disable them again
+ */
+static void fghDrawGeometry20(SFG_GeometryBuffers *buffers, GLboolean useWireMode,
+                              GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture)
+{
+    GLsizei   stride     = FGH_VERTEX_STRIDE(buffers);
+    GLboolean useCoords  = buffers->Vbo && attribute_v_coord   != -1;
+    GLboolean useNormals = buffers->Vbo && attribute_v_normal  != -1;
+    GLboolean useTextcs  = buffers->Vbo && buffers->HasTextcs && attribute_v_texture != -1;
+
+    if (buffers->Vbo)
+        fghBindBuffer(FGH_ARRAY_BUFFER, buffers->Vbo);
+
+    if (useCoords) {
         fghEnableVertexAttribArray(attribute_v_coord);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_coords);
         fghVertexAttribPointer(
             attribute_v_coord,  /* attribute */
             3,                  /* number of elements per vertex, here (x,y,z) */
             GL_FLOAT,           /* the type of each element */
             GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
+            stride,             /* from one vertex to the next */
             0                   /* offset of first element */
         );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
-    };
-    
-    if (vbo_normals) {
+    }
+
+    if (useNormals) {
         fghEnableVertexAttribArray(attribute_v_normal);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_normals);
         fghVertexAttribPointer(
             attribute_v_normal, /* attribute */
             3,                  /* number of elements per vertex, here (x,y,z) */
             GL_FLOAT,           /* the type of each element */
             GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
+            stride,             /* from one vertex to the next */
+            (GLvoid*)(3*sizeof(GLfloat))    /* offset of first element, after the coordinates */
         );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
-    };
+    }
 
-    if (vbo_textcs) {
+    if (useTextcs) {
         fghEnableVertexAttribArray(attribute_v_texture);
-        fghBindBuffer(FGH_ARRAY_BUFFER, vbo_textcs);
         fghVertexAttribPointer(
             attribute_v_texture,/* attribute */
             2,                  /* number of elements per vertex, here (s,t) */
             GL_FLOAT,           /* the type of each element */
             GL_FALSE,           /* take our values as-is */
-            0,                  /* no extra data between each position */
-            0                   /* offset of first element */
-            );
-        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
-    };
-    
-    if (vertIdxs == NULL) {
-        glDrawArrays(GL_TRIANGLES, 0, numVertices);
-    } else {
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, ibo_elements);
-        if (numParts>1) {
-            for (i=0; i<numParts; i++) {
-                glDrawElements(GL_TRIANGLE_STRIP, numVertIdxsPerPart, GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(vertIdxs[0])*i*numVertIdxsPerPart));
-            }
-        } else {
-            glDrawElements(GL_TRIANGLES, numVertIdxsPerPart, GL_UNSIGNED_SHORT, 0);
-        }
-        /* Clean existing bindings before clean-up */
-        /* Android showed instability otherwise */
-        fghBindBuffer(FGH_ELEMENT_ARRAY_BUFFER, 0);
+            stride,             /* from one vertex to the next */
+            (GLvoid*)(6*sizeof(GLfloat))    /* offset of first element, after the normals */
+        );
     }
-    
-    if (vbo_coords != 0)
+
+    if (buffers->Vbo)
+        fghBindBuffer(FGH_ARRAY_BUFFER, 0);
+
+    fghDrawInstances20(buffers, useWireMode);
+
+    if (useCoords)
         fghDisableVertexAttribArray(attribute_v_coord);
-    if (vbo_normals != 0)
+    if (useNormals)
         fghDisableVertexAttribArray(attribute_v_normal);
-    if (vbo_textcs != 0)
+    if (useTextcs)
         fghDisableVertexAttribArray(attribute_v_texture);
-    
-    if (vbo_coords != 0)
-        fghDeleteBuffers(1, &vbo_coords);
-    if (vbo_normals != 0)
-        fghDeleteBuffers(1, &vbo_normals);
-    if (vbo_textcs != 0)
-        fghDeleteBuffers(1, &vbo_textcs);
-    if (ibo_elements != 0)
-        fghDeleteBuffers(1, &ibo_elements);
+}
+
+static void fghDrawGeometryWire20(SFG_GeometryBuffers *buffers,
+                                  GLint attribute_v_coord, GLint attribute_v_normal)
+{
+    fghDrawGeometry20(buffers, GL_TRUE, attribute_v_coord, attribute_v_normal, -1);
+}
+
+static void fghDrawGeometrySolid20(SFG_GeometryBuffers *buffers,
+                                   GLint attribute_v_coord, GLint attribute_v_normal, GLint attribute_v_texture)
+{
+    fghDrawGeometry20(buffers, GL_FALSE, attribute_v_coord, attribute_v_normal, attribute_v_texture);
 }
 
 
@@ -1149,9 +1588,9 @@ static void fghCircleTable(GLfloat **sint, GLfloat **cost, const int n, const GL
 
 static void fghGenerateSphere(GLfloat radius, GLint slices, GLint stacks, GLfloat **vertices, GLfloat **normals, int* nVert)
 {
-    int i,j;
+    int i;
     int idx = 0;    /* idx into vertex/normal buffer */
-    GLfloat x,y,z;
+    GLfloat *vert,*norm;
 
     /* Pre-computed circle */
     GLfloat *sint1,*cost1;
@@ -1165,11 +1604,6 @@ static void fghGenerateSphere(GLfloat radius, GLint slices, GLint stacks, GLfloa
         return;
     }
     *nVert = slices*(stacks-1)+2;
-    if ((*nVert) > 65535)
-        /*
-         * limit of glushort, thats 256*256 subdivisions, should be enough in practice. See note above
-         */
-        fgWarning("fghGenerateSphere: too many slices or stacks requested, indices will wrap");
 
     /* precompute values on unit circle */
     fghCircleTable(&sint1,&cost1,-slices,GL_FALSE);
@@ -1184,41 +1618,29 @@ static void fghGenerateSphere(GLfloat radius, GLint slices, GLint stacks, GLfloa
         free(*normals);
         fgError("Failed to allocate memory in fghGenerateSphere");
     }
+    vert = *vertices;
+    norm = *normals;
 
     /* top */
-    (*vertices)[0] = 0.f;
-    (*vertices)[1] = 0.f;
-    (*vertices)[2] = radius;
-    (*normals )[0] = 0.f;
-    (*normals )[1] = 0.f;
-    (*normals )[2] = 1.f;
+    vert[0] = 0.f;
+    vert[1] = 0.f;
+    vert[2] = radius;
+    norm[0] = 0.f;
+    norm[1] = 0.f;
+    norm[2] = 1.f;
     idx = 3;
 
     /* each stack */
-    for( i=1; i<stacks; i++ )
-    {
-        for(j=0; j<slices; j++, idx+=3)
-        {
-            x = cost1[j]*sint2[i];
-            y = sint1[j]*sint2[i];
-            z = cost2[i];
-
-            (*vertices)[idx  ] = x*radius;
-            (*vertices)[idx+1] = y*radius;
-            (*vertices)[idx+2] = z*radius;
-            (*normals )[idx  ] = x;
-            (*normals )[idx+1] = y;
-            (*normals )[idx+2] = z;
-        }
-    }
+    for( i=1; i<stacks; i++, idx+=3*slices )
+        fgGeometrySphereRow(vert+idx,norm+idx,cost1,sint1,slices,sint2[i],cost2[i],radius);
 
     /* bottom */
-    (*vertices)[idx  ] =  0.f;
-    (*vertices)[idx+1] =  0.f;
-    (*vertices)[idx+2] = -radius;
-    (*normals )[idx  ] =  0.f;
-    (*normals )[idx+1] =  0.f;
-    (*normals )[idx+2] = -1.f;
+    vert[idx  ] =  0.f;
+    vert[idx+1] =  0.f;
+    vert[idx+2] = -radius;
+    norm[idx  ] =  0.f;
+    norm[idx+1] =  0.f;
+    norm[idx+2] = -1.f;
 
     /* Done creating vertices, release sin and cos tables */
     free(sint1);
@@ -1234,6 +1656,7 @@ void fghGenerateCone(
 {
     int i,j;
     int idx = 0;    /* idx into vertex/normal buffer */
+    GLfloat *vert,*norm;
 
     /* Pre-computed circle */
     GLfloat *sint,*cost;
@@ -1260,11 +1683,6 @@ void fghGenerateCone(
     }
     *nVert = slices*(stacks+2)+1;   /* need an extra stack for closing off bottom with correct normals */
 
-    if ((*nVert) > 65535)
-        /*
-         * limit of glushort, thats 256*256 subdivisions, should be enough in practice. See note above
-         */
-        fgWarning("fghGenerateCone: too many slices or stacks requested, indices will wrap");
 
     /* Pre-computed circle */
     fghCircleTable(&sint,&cost,-slices,GL_FALSE);
@@ -1278,38 +1696,32 @@ void fghGenerateCone(
         free(*normals);
         fgError("Failed to allocate memory in fghGenerateCone");
     }
+    vert = *vertices;
+    norm = *normals;
 
     /* bottom */
-    (*vertices)[0] =  0.f;
-    (*vertices)[1] =  0.f;
-    (*vertices)[2] =  z;
-    (*normals )[0] =  0.f;
-    (*normals )[1] =  0.f;
-    (*normals )[2] = -1.f;
+    vert[0] =  0.f;
+    vert[1] =  0.f;
+    vert[2] =  z;
+    norm[0] =  0.f;
+    norm[1] =  0.f;
+    norm[2] = -1.f;
     idx = 3;
     /* other on bottom (get normals right) */
     for (j=0; j<slices; j++, idx+=3)
     {
-        (*vertices)[idx  ] = cost[j]*r;
-        (*vertices)[idx+1] = sint[j]*r;
-        (*vertices)[idx+2] = z;
-        (*normals )[idx  ] =  0.f;
-        (*normals )[idx+1] =  0.f;
-        (*normals )[idx+2] = -1.f;
+        vert[idx  ] = cost[j]*r;
+        vert[idx+1] = sint[j]*r;
+        vert[idx+2] = z;
+        norm[idx  ] =  0.f;
+        norm[idx+1] =  0.f;
+        norm[idx+2] = -1.f;
     }
 
     /* each stack */
-    for (i=0; i<stacks+1; i++ )
+    for (i=0; i<stacks+1; i++, idx+=3*slices )
     {
-        for (j=0; j<slices; j++, idx+=3)
-        {
-            (*vertices)[idx  ] = cost[j]*r;
-            (*vertices)[idx+1] = sint[j]*r;
-            (*vertices)[idx+2] = z;
-            (*normals )[idx  ] = cost[j]*cosn;
-            (*normals )[idx+1] = sint[j]*cosn;
-            (*normals )[idx+2] = sinn;
-        }
+        fgGeometryRing(vert+idx,norm+idx,cost,sint,slices,r,z,cosn,sinn);
 
         z += zStep;
         r -= rStep;
@@ -1327,6 +1739,7 @@ void fghGenerateCylinder(
 {
     int i,j;
     int idx = 0;    /* idx into vertex/normal buffer */
+    GLfloat *vert,*norm;
 
     /* Step in z as stacks are drawn. */
     GLfloat radf = (GLfloat)radius;
@@ -1345,11 +1758,6 @@ void fghGenerateCylinder(
     }
     *nVert = slices*(stacks+3)+2;   /* need two extra stacks for closing off top and bottom with correct normals */
 
-    if ((*nVert) > 65535)
-        /*
-         * limit of glushort, thats 256*256 subdivisions, should be enough in practice. See note above
-         */
-        fgWarning("fghGenerateCylinder: too many slices or stacks requested, indices will wrap");
 
     /* Pre-computed circle */
     fghCircleTable(&sint,&cost,-slices,GL_FALSE);
@@ -1363,39 +1771,33 @@ void fghGenerateCylinder(
         free(*normals);
         fgError("Failed to allocate memory in fghGenerateCylinder");
     }
+    vert = *vertices;
+    norm = *normals;
 
     z=0;
     /* top on Z-axis */
-    (*vertices)[0] =  0.f;
-    (*vertices)[1] =  0.f;
-    (*vertices)[2] =  0.f;
-    (*normals )[0] =  0.f;
-    (*normals )[1] =  0.f;
-    (*normals )[2] = -1.f;
+    vert[0] =  0.f;
+    vert[1] =  0.f;
+    vert[2] =  0.f;
+    norm[0] =  0.f;
+    norm[1] =  0.f;
+    norm[2] = -1.f;
     idx = 3;
     /* other on top (get normals right) */
     for (j=0; j<slices; j++, idx+=3)
     {
-        (*vertices)[idx  ] = cost[j]*radf;
-        (*vertices)[idx+1] = sint[j]*radf;
-        (*vertices)[idx+2] = z;
-        (*normals )[idx  ] = 0.f;
-        (*normals )[idx+1] = 0.f;
-        (*normals )[idx+2] = -1.f;
+        vert[idx  ] = cost[j]*radf;
+        vert[idx+1] = sint[j]*radf;
+        vert[idx+2] = z;
+        norm[idx  ] = 0.f;
+        norm[idx+1] = 0.f;
+        norm[idx+2] = -1.f;
     }
 
-    /* each stack */
-    for (i=0; i<stacks+1; i++ )
+    /* each stack, the normals' cos*1 and sin*1 are exactly cos and sin */
+    for (i=0; i<stacks+1; i++, idx+=3*slices )
     {
-        for (j=0; j<slices; j++, idx+=3)
-        {
-            (*vertices)[idx  ] = cost[j]*radf;
-            (*vertices)[idx+1] = sint[j]*radf;
-            (*vertices)[idx+2] = z;
-            (*normals )[idx  ] = cost[j];
-            (*normals )[idx+1] = sint[j];
-            (*normals )[idx+2] = 0.f;
-        }
+        fgGeometryRing(vert+idx,norm+idx,cost,sint,slices,radf,z,1.f,0.f);
 
         z += zStep;
     }
@@ -1404,21 +1806,21 @@ void fghGenerateCylinder(
     z -= zStep;
     for (j=0; j<slices; j++, idx+=3)
     {
-        (*vertices)[idx  ] = cost[j]*radf;
-        (*vertices)[idx+1] = sint[j]*radf;
-        (*vertices)[idx+2] = z;
-        (*normals )[idx  ] = 0.f;
-        (*normals )[idx+1] = 0.f;
-        (*normals )[idx+2] = 1.f;
+        vert[idx  ] = cost[j]*radf;
+        vert[idx+1] = sint[j]*radf;
+        vert[idx+2] = z;
+        norm[idx  ] = 0.f;
+        norm[idx+1] = 0.f;
+        norm[idx+2] = 1.f;
     }
 
     /* bottom */
-    (*vertices)[idx  ] =  0.f;
-    (*vertices)[idx+1] =  0.f;
-    (*vertices)[idx+2] =  height;
-    (*normals )[idx  ] =  0.f;
-    (*normals )[idx+1] =  0.f;
-    (*normals )[idx+2] =  1.f;
+    vert[idx  ] =  0.f;
+    vert[idx+1] =  0.f;
+    vert[idx+2] =  height;
+    norm[idx  ] =  0.f;
+    norm[idx+1] =  0.f;
+    norm[idx+2] =  1.f;
 
     /* Release sin and cos tables */
     free(sint);
@@ -1432,7 +1834,8 @@ void fghGenerateTorus(
 {
     GLfloat  iradius = (float)dInnerRadius;
     GLfloat  oradius = (float)dOuterRadius;
-    int    i, j;
+    int    j;
+    GLfloat *vert, *norm;
 
     /* Pre-computed circle */
     GLfloat *spsi, *cpsi;
@@ -1447,11 +1850,6 @@ void fghGenerateTorus(
     }
     *nVert = nSides * nRings;
 
-    if ((*nVert) > 65535)
-        /*
-         * limit of glushort, thats 256*256 subdivisions, should be enough in practice. See note above
-         */
-        fgWarning("fghGenerateTorus: too many slices or stacks requested, indices will wrap");
 
     /* precompute values on unit circle */
     fghCircleTable(&spsi,&cpsi, nRings,GL_FALSE);
@@ -1466,21 +1864,12 @@ void fghGenerateTorus(
         free(*normals);
         fgError("Failed to allocate memory in fghGenerateTorus");
     }
+    vert = *vertices;
+    norm = *normals;
 
     for( j=0; j<nRings; j++ )
-    {
-        for( i=0; i<nSides; i++ )
-        {
-            int offset = 3 * ( j * nSides + i ) ;
-
-            (*vertices)[offset  ] = cpsi[j] * ( oradius + cphi[i] * iradius ) ;
-            (*vertices)[offset+1] = spsi[j] * ( oradius + cphi[i] * iradius ) ;
-            (*vertices)[offset+2] =                       sphi[i] * iradius  ;
-            (*normals )[offset  ] = cpsi[j] * cphi[i] ;
-            (*normals )[offset+1] = spsi[j] * cphi[i] ;
-            (*normals )[offset+2] =           sphi[i] ;
-        }
-    }
+        fgGeometryTorusRing(vert + 3 * j * nSides, norm + 3 * j * nSides, cphi, sphi, nSides,
+                            cpsi[j], spsi[j], iradius, oradius);
 
     /* Release sin and cos tables */
     free(spsi);
@@ -1489,10 +1878,272 @@ void fghGenerateTorus(
     free(cphi);
 }
 
+/*
+ * Tessellation cache for the non-polyhedra
+ *
+ * Generating a sphere, cone, cylinder or torus (sin and cos tables,
+ * vertices, normals and vertex index arrays) costs a lot more than drawing
+ * it. The index arrays only depend on the number of subdivisions and the
+ * vertices only depend on the size of the shape up to a scale factor, so
+ * we keep the unit-sized meshes of recently drawn shapes around and scale
+ * the vertices to the requested size when drawing:
+ *   sphere:   unit radius, scaled by radius
+ *   cone:     unit base with height/base as shape parameter, scaled by base
+ *   cylinder: unit radius and height, scaled by radius along x and y and
+ *             by height along z
+ *   torus:    unit outer radius with inner/outer radius as shape parameter,
+ *             scaled by outer radius
+ *   teaset:   unit scale, scaled by the size (see fg_teapot.c)
+ * The normals are not affected by these scale factors. A cone with
+ * base<=0 or a torus with outer radius<=0 can't be normalized this way
+ * (the normals would flip), these are generated anew for each call.
+ * The cache is kept in least recently used order and is limited to
+ * fgState.ShapeCacheMemory bytes (GLUT_SHAPE_CACHE_MEMORY).
+ */
+
+static SFG_List  shapeCache = { NULL, NULL };
+static size_t    shapeCacheSize = 0;
+static GLfloat  *scaledVertices = NULL;
+static int       numScaledVertices = 0;
+
+/*
+ * Find a mesh in the cache, and move it to the front as it is now the
+ * most recently used one. Returns NULL if the mesh has to be generated.
+ */
+SFG_Mesh *fghLookupMesh(fgShape shape, GLboolean useWireMode, GLfloat param, GLint subdiv1, GLint subdiv2)
+{
+    SFG_Mesh *mesh;
+
+    for( mesh = ( SFG_Mesh * )shapeCache.First;
+         mesh;
+         mesh = ( SFG_Mesh * )mesh->Node.Next )
+    {
+        if( mesh->Shape   == shape       &&
+            mesh->Wire    == useWireMode &&
+            mesh->Param   == param       &&
+            mesh->Subdiv1 == subdiv1     &&
+            mesh->Subdiv2 == subdiv2 )
+        {
+            if (mesh != shapeCache.First)
+            {
+                fgListRemove(&shapeCache, &mesh->Node);
+                fgListInsert(&shapeCache, shapeCache.First, &mesh->Node);
+            }
+            fgState.ShapeCacheHits++;
+            return mesh;
+        }
+    }
+
+    fgState.ShapeCacheMisses++;
+    return NULL;
+}
+
+/* Wrap generated vertices and normals in a mesh, which takes ownership of them */
+SFG_Mesh *fghCreateMesh(fgShape shape, GLboolean useWireMode, GLfloat param, GLint subdiv1, GLint subdiv2,
+                        GLfloat *vertices, GLfloat *normals, int nVert)
+{
+    SFG_Mesh *mesh = calloc(1, sizeof(SFG_Mesh));
+    if (!mesh)
+    {
+        free(vertices);
+        free(normals);
+        fgError("Failed to allocate memory in fghCreateMesh");
+    }
+
+    mesh->Shape       = shape;
+    mesh->Wire        = useWireMode;
+    mesh->Param       = param;
+    mesh->Subdiv1     = subdiv1;
+    mesh->Subdiv2     = subdiv2;
+    mesh->Vertices    = vertices;
+    mesh->Normals     = normals;
+    mesh->NumVertices = nVert;
+    return mesh;
+}
+
+/*
+ * Pick the vertex index type for a mesh: GLushort when its vertices can
+ * all be addressed with those, else GLuint if the context can draw them
+ */
+static GLenum fghMeshIndexType(int numVertices)
+{
+    if (numVertices <= 65536)
+        return GL_UNSIGNED_SHORT;
+    if (fgState.HasUintIndices)
+        return GL_UNSIGNED_INT;
+
+    fgWarning("fghMeshIndexType: %d vertices need 32-bit indices, which this context does not support, indices will wrap", numVertices);
+    return GL_UNSIGNED_SHORT;
+}
+
+/*
+ * Convert generated GLuint indices to idxType. For GL_UNSIGNED_SHORT they
+ * are copied into a new GLushort array, and the GLuint one is freed.
+ */
+static GLvoid *fghPackIndices(GLuint *vertIdxs, GLsizei numVertIdxs, GLenum idxType)
+{
+    GLushort *packed;
+    GLsizei i;
+
+    if (!vertIdxs || idxType == GL_UNSIGNED_INT)
+        return vertIdxs;
+
+    packed = malloc((numVertIdxs ? numVertIdxs : 1)*sizeof(GLushort));
+    if (!packed)
+    {
+        free(vertIdxs);
+        fgError("Failed to allocate memory in fghPackIndices");
+    }
+    for (i=0; i<numVertIdxs; i++)
+        packed[i] = (GLushort)vertIdxs[i];
+
+    free(vertIdxs);
+    return packed;
+}
+
+/*
+ * Store the vertex index arrays and drawing parameters, see
+ * fghDrawGeometryWire. The mesh takes ownership of the index arrays.
+ */
+void fghSetMeshWire(SFG_Mesh *mesh,
+                    GLuint *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
+                    GLuint *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2)
+{
+    mesh->IdxType         = fghMeshIndexType(mesh->NumVertices);
+    mesh->VertIdxs        = fghPackIndices(vertIdxs, numParts*numVertPerPart, mesh->IdxType);
+    mesh->NumParts        = numParts;
+    mesh->NumVertPerPart  = numVertPerPart;
+    mesh->VertexMode      = vertexMode;
+    mesh->VertIdxs2       = fghPackIndices(vertIdxs2, numParts2*numVertPerPart2, mesh->IdxType);
+    mesh->NumParts2       = numParts2;
+    mesh->NumVertPerPart2 = numVertPerPart2;
+}
+
+/*
+ * Store the vertex index array and drawing parameters, see
+ * fghDrawGeometrySolid. The mesh takes ownership of the index array.
+ */
+void fghSetMeshSolid(SFG_Mesh *mesh, GLuint *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart)
+{
+    mesh->IdxType        = fghMeshIndexType(mesh->NumVertices);
+    mesh->VertIdxs       = fghPackIndices(vertIdxs, numParts*numVertIdxsPerPart, mesh->IdxType);
+    mesh->NumParts       = numParts;
+    mesh->NumVertPerPart = numVertIdxsPerPart;
+}
+
+static void fghFreeMesh(SFG_Mesh *mesh)
+{
+    free(mesh->Vertices);
+    free(mesh->Normals);
+    free(mesh->Textcs);
+    free(mesh->VertIdxs);
+    free(mesh->VertIdxs2);
+    free(mesh);
+}
+
+/*
+ * Add a freshly generated mesh to the cache if it is cacheable and fits,
+ * evicting least recently used meshes as needed. Meshes that are not
+ * cached are freed by fghDrawMesh once drawn.
+ */
+void fghCacheMesh(SFG_Mesh *mesh, GLboolean cacheable)
+{
+    mesh->Size = sizeof(SFG_Mesh) +
+                 mesh->NumVertices*(mesh->Textcs ? 8 : 6)*sizeof(GLfloat) +
+                 (mesh->NumParts*mesh->NumVertPerPart + mesh->NumParts2*mesh->NumVertPerPart2)*FGH_INDEX_SIZE(mesh->IdxType);
+
+    if (!cacheable || mesh->Size > (size_t)fgState.ShapeCacheMemory)
+        return;
+
+    fgTrimShapeCache(fgState.ShapeCacheMemory - (int)mesh->Size);
+    fgListInsert(&shapeCache, shapeCache.First, &mesh->Node);
+    shapeCacheSize += mesh->Size;
+    mesh->Cached = GL_TRUE;
+}
+
+/* Evict least recently used meshes until the cache uses at most maxBytes */
+void fgTrimShapeCache( int maxBytes )
+{
+    SFG_Mesh *mesh;
+
+    while( shapeCacheSize > (size_t)( maxBytes > 0 ? maxBytes : 0 ) &&
+           ( mesh = ( SFG_Mesh * )shapeCache.Last ) )
+    {
+        fgListRemove( &shapeCache, &mesh->Node );
+        shapeCacheSize -= mesh->Size;
+        fghFreeMesh( mesh );
+    }
+}
+
+/* Release all cached meshes, scratch arrays and reset the statistics, for glutExit */
+void fgDestroyShapeCache( void )
+{
+    fgTrimShapeCache( 0 );
+
+    free( scaledVertices );
+    scaledVertices = NULL;
+    numScaledVertices = 0;
+    fghDestroyMultiDrawArrays( );
+
+    fgState.ShapeCacheHits   = 0;
+    fgState.ShapeCacheMisses = 0;
+}
+
+/*
+ * Draw a unit-sized mesh scaled to the requested size. The scaled vertices
+ * go into a scratch buffer that is reused between calls.
+ */
+void fghDrawMesh(const SFG_GeometryKey *key, SFG_Mesh *mesh, GLfloat scaleX, GLfloat scaleY, GLfloat scaleZ)
+{
+    GLfloat *vertices = mesh->Vertices;
+
+    if (scaleX!=1.f || scaleY!=1.f || scaleZ!=1.f)
+    {
+        int i;
+
+        if (numScaledVertices < mesh->NumVertices)
+        {
+            free(scaledVertices);
+            scaledVertices = malloc(mesh->NumVertices*3*sizeof(GLfloat));
+            if (!scaledVertices)
+            {
+                numScaledVertices = 0;
+                fgError("Failed to allocate memory in fghDrawMesh");
+            }
+            numScaledVertices = mesh->NumVertices;
+        }
+
+        for (i=0; i<mesh->NumVertices*3; i+=3)
+        {
+            scaledVertices[i  ] = mesh->Vertices[i  ]*scaleX;
+            scaledVertices[i+1] = mesh->Vertices[i+1]*scaleY;
+            scaledVertices[i+2] = mesh->Vertices[i+2]*scaleZ;
+        }
+        vertices = scaledVertices;
+    }
+
+    if (mesh->Wire)
+        fghDrawGeometryWire(key,vertices,mesh->Normals,mesh->NumVertices,mesh->IdxType,
+            mesh->VertIdxs,mesh->NumParts,mesh->NumVertPerPart,mesh->VertexMode,
+            mesh->VertIdxs2,mesh->NumParts2,mesh->NumVertPerPart2);
+    else
+        fghDrawGeometrySolid(key,vertices,mesh->Normals,mesh->Textcs,mesh->NumVertices,
+            mesh->IdxType,mesh->VertIdxs,mesh->NumParts,mesh->NumVertPerPart);
+
+    if (!mesh->Cached)
+        fghFreeMesh(mesh);
+}
+
+
 /* -- INTERNAL DRAWING functions --------------------------------------- */
 #define _DECLARE_INTERNAL_DRAW_DO_DECLARE(name,nameICaps,nameCaps,vertIdxs)\
     static void fgh##nameICaps( GLboolean useWireMode )\
     {\
+        SFG_GeometryKey key;\
+        fghInitGeometryKey(&key, FG_SHAPE_##nameCaps, useWireMode, 0, 0, 0, 0, 0);\
+        if (fghDrawCachedGeometry(&key))\
+            return;\
+        \
         if (!name##Cached)\
         {\
             fgh##nameICaps##Generate();\
@@ -1501,14 +2152,14 @@ void fghGenerateTorus(
         \
         if (useWireMode)\
         {\
-            fghDrawGeometryWire (name##_verts,name##_norms,nameCaps##_VERT_PER_OBJ, \
+            fghDrawGeometryWire (&key,name##_verts,name##_norms,nameCaps##_VERT_PER_OBJ,GL_UNSIGNED_SHORT,\
                                  NULL,nameCaps##_NUM_FACES,nameCaps##_NUM_EDGE_PER_FACE,GL_LINE_LOOP,\
                                  NULL,0,0);\
         }\
         else\
         {\
-            fghDrawGeometrySolid(name##_verts,name##_norms,NULL,nameCaps##_VERT_PER_OBJ,\
-                                 vertIdxs, 1, nameCaps##_VERT_PER_OBJ_TRI); \
+            fghDrawGeometrySolid(&key,name##_verts,name##_norms,NULL,nameCaps##_VERT_PER_OBJ,\
+                                 GL_UNSIGNED_SHORT,vertIdxs, 1, nameCaps##_VERT_PER_OBJ_TRI); \
         }\
     }
 #define DECLARE_INTERNAL_DRAW(name,nameICaps,nameCaps)                        _DECLARE_INTERNAL_DRAW_DO_DECLARE(name,nameICaps,nameCaps,NULL)
@@ -1517,6 +2168,11 @@ void fghGenerateTorus(
 static void fghCube( GLfloat dSize, GLboolean useWireMode )
 {
     GLfloat *vertices;
+    SFG_GeometryKey key;
+
+    fghInitGeometryKey(&key, FG_SHAPE_CUBE, useWireMode, dSize, 0, 0, 0, 0);
+    if (fghDrawCachedGeometry(&key))
+        return;
 
     if (!cubeCached)
     {
@@ -1545,12 +2201,12 @@ static void fghCube( GLfloat dSize, GLboolean useWireMode )
         vertices = cube_verts;
 
     if (useWireMode)
-        fghDrawGeometryWire(vertices, cube_norms, CUBE_VERT_PER_OBJ,
+        fghDrawGeometryWire(&key, vertices, cube_norms, CUBE_VERT_PER_OBJ, GL_UNSIGNED_SHORT,
                             NULL,CUBE_NUM_FACES, CUBE_NUM_EDGE_PER_FACE,GL_LINE_LOOP,
                             NULL,0,0);
     else
-        fghDrawGeometrySolid(vertices, cube_norms, NULL, CUBE_VERT_PER_OBJ,
-                             cube_vertIdxs, 1, CUBE_VERT_PER_OBJ_TRI);
+        fghDrawGeometrySolid(&key, vertices, cube_norms, NULL, CUBE_VERT_PER_OBJ,
+                             GL_UNSIGNED_SHORT, cube_vertIdxs, 1, CUBE_VERT_PER_OBJ_TRI);
 
     if (dSize!=1.f)
         /* cleanup allocated memory */
@@ -1570,9 +2226,15 @@ static void fghSierpinskiSponge ( int numLevels, double offset[3], GLfloat scale
     GLsizei    numTetr = numLevels<0? 0 : ipow(4,numLevels); /* No sponge for numLevels below 0 */
     GLsizei    numVert = numTetr*TETRAHEDRON_VERT_PER_OBJ;
     GLsizei    numFace = numTetr*TETRAHEDRON_NUM_FACES;
+    SFG_GeometryKey key;
 
     if (numTetr)
     {
+        fghInitGeometryKey(&key, FG_SHAPE_SIERPINSKISPONGE, useWireMode,
+                           numLevels, offset[0], offset[1], offset[2], scale);
+        if (fghDrawCachedGeometry(&key))
+            return;
+
         /* Allocate memory */
         vertices = malloc(numVert*3 * sizeof(GLfloat));
         normals  = malloc(numVert*3 * sizeof(GLfloat));
@@ -1589,11 +2251,11 @@ static void fghSierpinskiSponge ( int numLevels, double offset[3], GLfloat scale
 
         /* Draw and cleanup */
         if (useWireMode)
-            fghDrawGeometryWire (vertices,normals,numVert,
+            fghDrawGeometryWire (&key,vertices,normals,numVert,GL_UNSIGNED_SHORT,
                                  NULL,numFace,TETRAHEDRON_NUM_EDGE_PER_FACE,GL_LINE_LOOP,
                                  NULL,0,0);
         else
-            fghDrawGeometrySolid(vertices,normals,NULL,numVert,NULL,1,0);
+            fghDrawGeometrySolid(&key,vertices,normals,NULL,numVert,GL_UNSIGNED_SHORT,NULL,1,0);
 
         free(vertices);
         free(normals );
@@ -1601,39 +2263,41 @@ static void fghSierpinskiSponge ( int numLevels, double offset[3], GLfloat scale
 }
 
 
-static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean useWireMode )
+static SFG_Mesh *fghGenerateSphereMesh( GLint slices, GLint stacks, GLboolean useWireMode )
 {
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
+    SFG_Mesh *mesh;
 
     /* Generate vertices and normals */
-    fghGenerateSphere(radius,slices,stacks,&vertices,&normals,&nVert);
+    fghGenerateSphere(1.f,slices,stacks,&vertices,&normals,&nVert);
     
     if (nVert==0)
         /* nothing to draw */
-        return;
+        return NULL;
+    mesh = fghCreateMesh(FG_SHAPE_SPHERE,useWireMode,0.f,slices,stacks,vertices,normals,nVert);
 
     if (useWireMode)
     {
-        GLushort  *sliceIdx, *stackIdx;
+        GLuint  *sliceIdx, *stackIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
          * We have a bunch of line_loops to draw for each stack, and a
          * bunch for each slice.
          */
 
-        sliceIdx = malloc(slices*(stacks+1)*sizeof(GLushort));
-        stackIdx = malloc(slices*(stacks-1)*sizeof(GLushort));
+        sliceIdx = malloc(slices*(stacks+1)*sizeof(GLuint));
+        stackIdx = malloc(slices*(stacks-1)*sizeof(GLuint));
         if (!(stackIdx) || !(sliceIdx))
         {
             free(stackIdx);
             free(sliceIdx);
-            fgError("Failed to allocate memory in fghSphere");
+            fgError("Failed to allocate memory in fghGenerateSphereMesh");
         }
 
         /* generate for each stack */
         for (i=0,idx=0; i<stacks-1; i++)
         {
-            GLushort offset = 1+i*slices;           /* start at 1 (0 is top vertex), and we advance one stack down as we go along */
+            GLuint offset = 1+i*slices;             /* start at 1 (0 is top vertex), and we advance one stack down as we go along */
             for (j=0; j<slices; j++, idx++)
             {
                 stackIdx[idx] = offset+j;
@@ -1643,7 +2307,7 @@ static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean use
         /* generate for each slice */
         for (i=0,idx=0; i<slices; i++)
         {
-            GLushort offset = 1+i;                  /* start at 1 (0 is top vertex), and we advance one slice as we go along */
+            GLuint offset = 1+i;                    /* start at 1 (0 is top vertex), and we advance one slice as we go along */
             sliceIdx[idx++] = 0;                    /* vertex on top */
             for (j=0; j<stacks-1; j++, idx++)
             {
@@ -1652,14 +2316,10 @@ static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean use
             sliceIdx[idx++] = nVert-1;              /* zero based index, last element in array... */
         }
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
+        /* store in mesh */
+        fghSetMeshWire(mesh,
             sliceIdx,slices,stacks+1,GL_LINE_STRIP,
             stackIdx,stacks-1,slices);
-        
-        /* cleanup allocated memory */
-        free(sliceIdx);
-        free(stackIdx);
     }
     else
     {
@@ -1667,16 +2327,16 @@ static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean use
          * All stacks, including top and bottom are covered with a triangle
          * strip.
          */
-        GLushort  *stripIdx;
+        GLuint  *stripIdx;
         /* Create index vector */
-        GLushort offset;
+        GLuint offset;
 
         /* Allocate buffers for indices, bail out if memory allocation fails */
-        stripIdx = malloc((slices+1)*2*(stacks)*sizeof(GLushort));
+        stripIdx = malloc((slices+1)*2*(stacks)*sizeof(GLuint));
         if (!(stripIdx))
         {
             free(stripIdx);
-            fgError("Failed to allocate memory in fghSphere");
+            fgError("Failed to allocate memory in fghGenerateSphereMesh");
         }
 
         /* top stack */
@@ -1714,22 +2374,36 @@ static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean use
         stripIdx[idx+1] = offset;
 
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,stacks,(slices+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* store in mesh */
+        fghSetMeshSolid(mesh,stripIdx,stacks,(slices+1)*2);
     }
-    
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+
+    fghCacheMesh(mesh,GL_TRUE);
+    return mesh;
 }
 
-static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+static void fghSphere( GLfloat radius, GLint slices, GLint stacks, GLboolean useWireMode )
+{
+    SFG_GeometryKey key;
+    SFG_Mesh *mesh;
+
+    fghInitGeometryKey(&key, FG_SHAPE_SPHERE, useWireMode, radius, slices, stacks, 0, 0);
+    if (fghDrawCachedGeometry(&key))
+        /* already in buffers, nothing to generate */
+        return;
+
+    mesh = fghLookupMesh(FG_SHAPE_SPHERE,useWireMode,0.f,slices,stacks);
+    if (!mesh)
+        mesh = fghGenerateSphereMesh(slices,stacks,useWireMode);
+    if (mesh)
+        fghDrawMesh(&key,mesh,radius,radius,radius);
+}
+
+static SFG_Mesh *fghGenerateConeMesh( GLfloat base, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode, GLboolean cacheable )
 {
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
+    SFG_Mesh *mesh;
 
     /* Generate vertices and normals */
     /* Note, (stacks+1)*slices vertices for side of object, slices+1 for top and bottom closures */
@@ -1737,29 +2411,30 @@ static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, G
 
     if (nVert==0)
         /* nothing to draw */
-        return;
+        return NULL;
+    mesh = fghCreateMesh(FG_SHAPE_CONE,useWireMode,height,slices,stacks,vertices,normals,nVert);
 
     if (useWireMode)
     {
-        GLushort  *sliceIdx, *stackIdx;
+        GLuint  *sliceIdx, *stackIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
          * We have a bunch of line_loops to draw for each stack, and a
          * bunch for each slice.
          */
 
-        stackIdx = malloc(slices*stacks*sizeof(GLushort));
-        sliceIdx = malloc(slices*2     *sizeof(GLushort));
+        stackIdx = malloc(slices*stacks*sizeof(GLuint));
+        sliceIdx = malloc(slices*2     *sizeof(GLuint));
         if (!(stackIdx) || !(sliceIdx))
         {
             free(stackIdx);
             free(sliceIdx);
-            fgError("Failed to allocate memory in fghCone");
+            fgError("Failed to allocate memory in fghGenerateConeMesh");
         }
 
         /* generate for each stack */
         for (i=0,idx=0; i<stacks; i++)
         {
-            GLushort offset = 1+(i+1)*slices;       /* start at 1 (0 is top vertex), and we advance one stack down as we go along */
+            GLuint offset = 1+(i+1)*slices;         /* start at 1 (0 is top vertex), and we advance one stack down as we go along */
             for (j=0; j<slices; j++, idx++)
             {
                 stackIdx[idx] = offset+j;
@@ -1769,19 +2444,15 @@ static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, G
         /* generate for each slice */
         for (i=0,idx=0; i<slices; i++)
         {
-            GLushort offset = 1+i;                  /* start at 1 (0 is top vertex), and we advance one slice as we go along */
+            GLuint offset = 1+i;                    /* start at 1 (0 is top vertex), and we advance one slice as we go along */
             sliceIdx[idx++] = offset+slices;
             sliceIdx[idx++] = offset+(stacks+1)*slices;
         }
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
+        /* store in mesh */
+        fghSetMeshWire(mesh,
             sliceIdx,1,slices*2,GL_LINES,
             stackIdx,stacks,slices);
-
-        /* cleanup allocated memory */
-        free(sliceIdx);
-        free(stackIdx);
     }
     else
     {
@@ -1789,16 +2460,16 @@ static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, G
          * All stacks, including top and bottom are covered with a triangle
          * strip.
          */
-        GLushort  *stripIdx;
+        GLuint  *stripIdx;
         /* Create index vector */
-        GLushort offset;
+        GLuint offset;
 
         /* Allocate buffers for indices, bail out if memory allocation fails */
-        stripIdx = malloc((slices+1)*2*(stacks+1)*sizeof(GLushort));    /*stacks +1 because of closing off bottom */
+        stripIdx = malloc((slices+1)*2*(stacks+1)*sizeof(GLuint));    /*stacks +1 because of closing off bottom */
         if (!(stripIdx))
         {
             free(stripIdx);
-            fgError("Failed to allocate memory in fghCone");
+            fgError("Failed to allocate memory in fghGenerateConeMesh");
         }
 
         /* top stack */
@@ -1825,52 +2496,78 @@ static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, G
             stripIdx[idx+1] = offset+slices;
         }
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,stacks+1,(slices+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* store in mesh */
+        fghSetMeshSolid(mesh,stripIdx,stacks+1,(slices+1)*2);
     }
 
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+    fghCacheMesh(mesh,cacheable);
+    return mesh;
 }
 
-static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+static void fghCone( GLfloat base, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+{
+    SFG_GeometryKey key;
+    SFG_Mesh *mesh;
+
+    fghInitGeometryKey(&key, FG_SHAPE_CONE, useWireMode, base, height, slices, stacks, 0);
+    if (fghDrawCachedGeometry(&key))
+        /* already in buffers, nothing to generate */
+        return;
+
+    if (base > 0.f)
+    {
+        /* unit base, the height to base ratio determines the shape */
+        mesh = fghLookupMesh(FG_SHAPE_CONE,useWireMode,height/base,slices,stacks);
+        if (!mesh)
+            mesh = fghGenerateConeMesh(1.f,height/base,slices,stacks,useWireMode,GL_TRUE);
+        if (mesh)
+            fghDrawMesh(&key,mesh,base,base,base);
+    }
+    else
+    {
+        /* can't normalize, generate as is */
+        mesh = fghGenerateConeMesh(base,height,slices,stacks,useWireMode,GL_FALSE);
+        if (mesh)
+            fghDrawMesh(&key,mesh,1.f,1.f,1.f);
+    }
+}
+
+static SFG_Mesh *fghGenerateCylinderMesh( GLint slices, GLint stacks, GLboolean useWireMode )
 {
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
+    SFG_Mesh *mesh;
 
     /* Generate vertices and normals */
     /* Note, (stacks+1)*slices vertices for side of object, 2*slices+2 for top and bottom closures */
-    fghGenerateCylinder(radius,height,slices,stacks,&vertices,&normals,&nVert);
+    fghGenerateCylinder(1.f,1.f,slices,stacks,&vertices,&normals,&nVert);
 
     if (nVert==0)
         /* nothing to draw */
-        return;
+        return NULL;
+    mesh = fghCreateMesh(FG_SHAPE_CYLINDER,useWireMode,0.f,slices,stacks,vertices,normals,nVert);
 
     if (useWireMode)
     {
-        GLushort  *sliceIdx, *stackIdx;
+        GLuint  *sliceIdx, *stackIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
          * We have a bunch of line_loops to draw for each stack, and a
          * bunch for each slice.
          */
 
-        stackIdx = malloc(slices*(stacks+1)*sizeof(GLushort));
-        sliceIdx = malloc(slices*2         *sizeof(GLushort));
+        stackIdx = malloc(slices*(stacks+1)*sizeof(GLuint));
+        sliceIdx = malloc(slices*2         *sizeof(GLuint));
         if (!(stackIdx) || !(sliceIdx))
         {
             free(stackIdx);
             free(sliceIdx);
-            fgError("Failed to allocate memory in fghCylinder");
+            fgError("Failed to allocate memory in fghGenerateCylinderMesh");
         }
 
         /* generate for each stack */
         for (i=0,idx=0; i<stacks+1; i++)
         {
-            GLushort offset = 1+(i+1)*slices;       /* start at 1 (0 is top vertex), and we advance one stack down as we go along */
+            GLuint offset = 1+(i+1)*slices;         /* start at 1 (0 is top vertex), and we advance one stack down as we go along */
             for (j=0; j<slices; j++, idx++)
             {
                 stackIdx[idx] = offset+j;
@@ -1880,19 +2577,15 @@ static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint sta
         /* generate for each slice */
         for (i=0,idx=0; i<slices; i++)
         {
-            GLushort offset = 1+i;                  /* start at 1 (0 is top vertex), and we advance one slice as we go along */
+            GLuint offset = 1+i;                    /* start at 1 (0 is top vertex), and we advance one slice as we go along */
             sliceIdx[idx++] = offset+slices;
             sliceIdx[idx++] = offset+(stacks+1)*slices;
         }
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
+        /* store in mesh */
+        fghSetMeshWire(mesh,
             sliceIdx,1,slices*2,GL_LINES,
             stackIdx,stacks+1,slices);
-
-        /* cleanup allocated memory */
-        free(sliceIdx);
-        free(stackIdx);
     }
     else
     {
@@ -1900,16 +2593,16 @@ static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint sta
          * All stacks, including top and bottom are covered with a triangle
          * strip.
          */
-        GLushort  *stripIdx;
+        GLuint  *stripIdx;
         /* Create index vector */
-        GLushort offset;
+        GLuint offset;
 
         /* Allocate buffers for indices, bail out if memory allocation fails */
-        stripIdx = malloc((slices+1)*2*(stacks+2)*sizeof(GLushort));    /*stacks +2 because of closing off bottom and top */
+        stripIdx = malloc((slices+1)*2*(stacks+2)*sizeof(GLuint));    /*stacks +2 because of closing off bottom and top */
         if (!(stripIdx))
         {
             free(stripIdx);
-            fgError("Failed to allocate memory in fghCylinder");
+            fgError("Failed to allocate memory in fghGenerateCylinderMesh");
         }
 
         /* top stack */
@@ -1946,45 +2639,60 @@ static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint sta
         stripIdx[idx  ] = offset;
         stripIdx[idx+1] = nVert-1;                  /* repeat first slice's idx for closing off shape */
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,stacks+2,(slices+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* store in mesh */
+        fghSetMeshSolid(mesh,stripIdx,stacks+2,(slices+1)*2);
     }
 
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+    fghCacheMesh(mesh,GL_TRUE);
+    return mesh;
 }
 
-static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides, GLint nRings, GLboolean useWireMode )
+static void fghCylinder( GLfloat radius, GLfloat height, GLint slices, GLint stacks, GLboolean useWireMode )
+{
+    SFG_GeometryKey key;
+    SFG_Mesh *mesh;
+
+    fghInitGeometryKey(&key, FG_SHAPE_CYLINDER, useWireMode, radius, height, slices, stacks, 0);
+    if (fghDrawCachedGeometry(&key))
+        /* already in buffers, nothing to generate */
+        return;
+
+    mesh = fghLookupMesh(FG_SHAPE_CYLINDER,useWireMode,0.f,slices,stacks);
+    if (!mesh)
+        mesh = fghGenerateCylinderMesh(slices,stacks,useWireMode);
+    if (mesh)
+        fghDrawMesh(&key,mesh,radius,radius,height);
+}
+
+static SFG_Mesh *fghGenerateTorusMesh( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides, GLint nRings, GLboolean useWireMode, GLboolean cacheable )
 {
     int i,j,idx, nVert;
     GLfloat *vertices, *normals;
+    SFG_Mesh *mesh;
 
     /* Generate vertices and normals */
     fghGenerateTorus(dInnerRadius,dOuterRadius,nSides,nRings, &vertices,&normals,&nVert);
 
     if (nVert==0)
         /* nothing to draw */
-        return;
+        return NULL;
+    mesh = fghCreateMesh(FG_SHAPE_TORUS,useWireMode,dInnerRadius,nSides,nRings,vertices,normals,nVert);
 
     if (useWireMode)
     {
-        GLushort  *sideIdx, *ringIdx;
+        GLuint  *sideIdx, *ringIdx;
         /* First, generate vertex index arrays for drawing with glDrawElements
          * We have a bunch of line_loops to draw each side, and a
          * bunch for each ring.
          */
 
-        ringIdx = malloc(nRings*nSides*sizeof(GLushort));
-        sideIdx = malloc(nSides*nRings*sizeof(GLushort));
+        ringIdx = malloc(nRings*nSides*sizeof(GLuint));
+        sideIdx = malloc(nSides*nRings*sizeof(GLuint));
         if (!(ringIdx) || !(sideIdx))
         {
             free(ringIdx);
             free(sideIdx);
-            fgError("Failed to allocate memory in fghTorus");
+            fgError("Failed to allocate memory in fghGenerateTorusMesh");
         }
 
         /* generate for each ring */
@@ -1997,14 +2705,10 @@ static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides,
             for( j=0; j<nRings; j++, idx++ )
                 sideIdx[idx] = j * nSides + i;
 
-        /* draw */
-        fghDrawGeometryWire(vertices,normals,nVert,
+        /* store in mesh */
+        fghSetMeshWire(mesh,
             ringIdx,nRings,nSides,GL_LINE_LOOP,
             sideIdx,nSides,nRings);
-        
-        /* cleanup allocated memory */
-        free(sideIdx);
-        free(ringIdx);
     }
     else
     {
@@ -2012,14 +2716,14 @@ static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides,
          * All stacks, including top and bottom are covered with a triangle
          * strip.
          */
-        GLushort  *stripIdx;
+        GLuint  *stripIdx;
 
         /* Allocate buffers for indices, bail out if memory allocation fails */
-        stripIdx = malloc((nRings+1)*2*nSides*sizeof(GLushort));
+        stripIdx = malloc((nRings+1)*2*nSides*sizeof(GLuint));
         if (!(stripIdx))
         {
             free(stripIdx);
-            fgError("Failed to allocate memory in fghTorus");
+            fgError("Failed to allocate memory in fghGenerateTorusMesh");
         }
 
         for( i=0, idx=0; i<nSides; i++ )
@@ -2040,16 +2744,40 @@ static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides,
             idx +=2;
         }
 
-        /* draw */
-        fghDrawGeometrySolid(vertices,normals,NULL,nVert,stripIdx,nSides,(nRings+1)*2);
-
-        /* cleanup allocated memory */
-        free(stripIdx);
+        /* store in mesh */
+        fghSetMeshSolid(mesh,stripIdx,nSides,(nRings+1)*2);
     }
 
-    /* cleanup allocated memory */
-    free(vertices);
-    free(normals);
+    fghCacheMesh(mesh,cacheable);
+    return mesh;
+}
+
+static void fghTorus( GLfloat dInnerRadius, GLfloat dOuterRadius, GLint nSides, GLint nRings, GLboolean useWireMode )
+{
+    SFG_GeometryKey key;
+    SFG_Mesh *mesh;
+
+    fghInitGeometryKey(&key, FG_SHAPE_TORUS, useWireMode, dInnerRadius, dOuterRadius, nSides, nRings, 0);
+    if (fghDrawCachedGeometry(&key))
+        /* already in buffers, nothing to generate */
+        return;
+
+    if (dOuterRadius > 0.f)
+    {
+        /* unit outer radius, the ratio of the radii determines the shape */
+        mesh = fghLookupMesh(FG_SHAPE_TORUS,useWireMode,dInnerRadius/dOuterRadius,nSides,nRings);
+        if (!mesh)
+            mesh = fghGenerateTorusMesh(dInnerRadius/dOuterRadius,1.f,nSides,nRings,useWireMode,GL_TRUE);
+        if (mesh)
+            fghDrawMesh(&key,mesh,dOuterRadius,dOuterRadius,dOuterRadius);
+    }
+    else
+    {
+        /* can't normalize, generate as is */
+        mesh = fghGenerateTorusMesh(dInnerRadius,dOuterRadius,nSides,nRings,useWireMode,GL_FALSE);
+        if (mesh)
+            fghDrawMesh(&key,mesh,1.f,1.f,1.f);
+    }
 }
 
 
@@ -2131,6 +2859,47 @@ void FGAPIENTRY glutSolidTorus( double dInnerRadius, double dOuterRadius, GLint
 }
 
 
+/*
+ * Instanced versions of the above: draw count copies of the shape, each
+ * transformed by a column-major 4x4 matrix from transforms and, if colors
+ * is not NULL, with an RGBA color from colors
+ */
+#define DECLARE_INSTANCED_INTERFACE(nameICaps,args,drawCall)\
+    void FGAPIENTRY glutWire##nameICaps##Instanced args\
+    {\
+        const GLboolean useWireMode = GL_TRUE;\
+        FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWire"#nameICaps"Instanced" );\
+        if (fghBeginInstances(count, transforms, colors))\
+        {\
+            drawCall;\
+            fghEndInstances();\
+        }\
+    }\
+    void FGAPIENTRY glutSolid##nameICaps##Instanced args\
+    {\
+        const GLboolean useWireMode = GL_FALSE;\
+        FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolid"#nameICaps"Instanced" );\
+        if (fghBeginInstances(count, transforms, colors))\
+        {\
+            drawCall;\
+            fghEndInstances();\
+        }\
+    }
+
+DECLARE_INSTANCED_INTERFACE(Sphere,
+    ( double radius, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors ),
+    fghSphere( (GLfloat)radius, slices, stacks, useWireMode ))
+DECLARE_INSTANCED_INTERFACE(Cone,
+    ( double base, double height, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors ),
+    fghCone( (GLfloat)base, (GLfloat)height, slices, stacks, useWireMode ))
+DECLARE_INSTANCED_INTERFACE(Cylinder,
+    ( double radius, double height, GLint slices, GLint stacks, GLsizei count, const GLfloat *transforms, const GLfloat *colors ),
+    fghCylinder( (GLfloat)radius, (GLfloat)height, slices, stacks, useWireMode ))
+DECLARE_INSTANCED_INTERFACE(Torus,
+    ( double dInnerRadius, double dOuterRadius, GLint nSides, GLint nRings, GLsizei count, const GLfloat *transforms, const GLfloat *colors ),
+    fghTorus( (GLfloat)dInnerRadius, (GLfloat)dOuterRadius, nSides, nRings, useWireMode ))
+
+
 
 /* -- INTERFACE FUNCTIONS -------------------------------------------------- */
 /* Macro to generate interface functions */
@@ -2156,6 +2925,9 @@ void FGAPIENTRY glutSolidCube( double dSize )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidCube" );
     fghCube( (GLfloat)dSize, GL_FALSE );
 }
+DECLARE_INSTANCED_INTERFACE(Cube,
+    ( double dSize, GLsizei count, const GLfloat *transforms, const GLfloat *colors ),
+    fghCube( (GLfloat)dSize, useWireMode ))
 
 DECLARE_SHAPE_INTERFACE(Dodecahedron)
 DECLARE_SHAPE_INTERFACE(Icosahedron)
@@ -0,0 +1,253 @@
+/*
+ * fg_geometry_kernels.c
+ *
+ * The inner loops generating the vertices and normals of the sphere, cone,
+ * cylinder and torus in fg_geometry.c, with SSE2 or NEON versions where
+ * the compiler targets them. Every kernel writes one row or ring of x,y,z
+ * triplets, exactly as its scalar version does: they do the same single
+ * precision operations in the same order. That only holds if the compiler
+ * doesn't fuse multiplies and adds, hence -ffp-contract=off for this file.
+ * The file only needs the GL types, so that the meshgen demo can build it
+ * in to compare and time both versions.
+ *
+ * Creation date: Fri Oct 16 2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * PAWEL W. OLSZTA BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <GL/freeglut.h>
+
+/*
+ * Only instruction sets every build for the target has are used, there is
+ * no run time dispatch: SSE2 is part of x86-64, and of 32 bit x86 builds
+ * asking for it, NEON of AArch64 and of ARM builds asking for it.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define FGH_KERNELS_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define FGH_KERNELS_NEON
+#   include <arm_neon.h>
+#endif
+
+/*
+ * Store 4 x,y,z triplets given as vectors of their x, y and z, to 12
+ * consecutive floats
+ */
+#ifdef FGH_KERNELS_SSE2
+static void fghStoreTriplets4( GLfloat *out, __m128 x, __m128 y, __m128 z )
+{
+    const __m128 xy01 = _mm_unpacklo_ps( x, y ), xy23 = _mm_unpackhi_ps( x, y );
+    const __m128 yz01 = _mm_unpacklo_ps( y, z ), yz23 = _mm_unpackhi_ps( y, z );
+    const __m128 zx01 = _mm_unpacklo_ps( z, x ), zx23 = _mm_unpackhi_ps( z, x );
+
+    _mm_storeu_ps( out,     _mm_shuffle_ps( xy01, zx01, _MM_SHUFFLE( 3, 0, 1, 0 ) ) );   /* x0 y0 z0 x1 */
+    _mm_storeu_ps( out + 4, _mm_shuffle_ps( yz01, xy23, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );   /* y1 z1 x2 y2 */
+    _mm_storeu_ps( out + 8, _mm_shuffle_ps( zx23, yz23, _MM_SHUFFLE( 3, 2, 3, 0 ) ) );   /* z2 x3 y3 z3 */
+}
+#endif
+
+/*
+ * A ring of n vertices around the z axis at height z with radius r, for
+ * the cone's and cylinder's sides: vertex (cos*r, sin*r, z), normal
+ * (cos*nScale, sin*nScale, nz)
+ */
+void fgGeometryRingScalar( GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+                           GLfloat r, GLfloat z, GLfloat nScale, GLfloat nz )
+{
+    int j;
+
+    for( j=0; j<n; j++, vert+=3, norm+=3 )
+    {
+        vert[0] = cost[j]*r;
+        vert[1] = sint[j]*r;
+        vert[2] = z;
+        norm[0] = cost[j]*nScale;
+        norm[1] = sint[j]*nScale;
+        norm[2] = nz;
+    }
+}
+
+void fgGeometryRing( GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+                     GLfloat r, GLfloat z, GLfloat nScale, GLfloat nz )
+{
+    int j = 0;
+
+#if defined(FGH_KERNELS_SSE2)
+    const __m128 vr = _mm_set1_ps( r ), vz = _mm_set1_ps( z );
+    const __m128 vs = _mm_set1_ps( nScale ), vnz = _mm_set1_ps( nz );
+
+    for( ; j+4<=n; j+=4, vert+=12, norm+=12 )
+    {
+        const __m128 c = _mm_loadu_ps( cost+j ), s = _mm_loadu_ps( sint+j );
+
+        fghStoreTriplets4( vert, _mm_mul_ps( c, vr ), _mm_mul_ps( s, vr ), vz );
+        fghStoreTriplets4( norm, _mm_mul_ps( c, vs ), _mm_mul_ps( s, vs ), vnz );
+    }
+#elif defined(FGH_KERNELS_NEON)
+    for( ; j+4<=n; j+=4, vert+=12, norm+=12 )
+    {
+        const float32x4_t c = vld1q_f32( cost+j ), s = vld1q_f32( sint+j );
+        float32x4x3_t v, nv;
+
+        v.val[0] = vmulq_n_f32( c, r );
+        v.val[1] = vmulq_n_f32( s, r );
+        v.val[2] = vdupq_n_f32( z );
+        nv.val[0] = vmulq_n_f32( c, nScale );
+        nv.val[1] = vmulq_n_f32( s, nScale );
+        nv.val[2] = vdupq_n_f32( nz );
+        vst3q_f32( vert, v );
+        vst3q_f32( norm, nv );
+    }
+#endif
+
+    fgGeometryRingScalar( vert, norm, cost+j, sint+j, n-j, r, z, nScale, nz );
+}
+
+/*
+ * A row of n vertices of a sphere, on the circle at height z with radius s
+ * of the unit sphere: normal (cos*s, sin*s, z), vertex the normal times
+ * radius
+ */
+void fgGeometrySphereRowScalar( GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+                                GLfloat s, GLfloat z, GLfloat radius )
+{
+    const GLfloat vz = z*radius;
+    int j;
+
+    for( j=0; j<n; j++, vert+=3, norm+=3 )
+    {
+        const GLfloat x = cost[j]*s;
+        const GLfloat y = sint[j]*s;
+
+        vert[0] = x*radius;
+        vert[1] = y*radius;
+        vert[2] = vz;
+        norm[0] = x;
+        norm[1] = y;
+        norm[2] = z;
+    }
+}
+
+void fgGeometrySphereRow( GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+                          GLfloat s, GLfloat z, GLfloat radius )
+{
+    int j = 0;
+
+#if defined(FGH_KERNELS_SSE2)
+    const __m128 vs = _mm_set1_ps( s ), vradius = _mm_set1_ps( radius );
+    const __m128 vz = _mm_set1_ps( z ), vvz = _mm_set1_ps( z*radius );
+
+    for( ; j+4<=n; j+=4, vert+=12, norm+=12 )
+    {
+        const __m128 x = _mm_mul_ps( _mm_loadu_ps( cost+j ), vs );
+        const __m128 y = _mm_mul_ps( _mm_loadu_ps( sint+j ), vs );
+
+        fghStoreTriplets4( vert, _mm_mul_ps( x, vradius ), _mm_mul_ps( y, vradius ), vvz );
+        fghStoreTriplets4( norm, x, y, vz );
+    }
+#elif defined(FGH_KERNELS_NEON)
+    for( ; j+4<=n; j+=4, vert+=12, norm+=12 )
+    {
+        float32x4x3_t v, nv;
+
+        nv.val[0] = vmulq_n_f32( vld1q_f32( cost+j ), s );
+        nv.val[1] = vmulq_n_f32( vld1q_f32( sint+j ), s );
+        nv.val[2] = vdupq_n_f32( z );
+        v.val[0] = vmulq_n_f32( nv.val[0], radius );
+        v.val[1] = vmulq_n_f32( nv.val[1], radius );
+        v.val[2] = vdupq_n_f32( z*radius );
+        vst3q_f32( vert, v );
+        vst3q_f32( norm, nv );
+    }
+#endif
+
+    fgGeometrySphereRowScalar( vert, norm, cost+j, sint+j, n-j, s, z, radius );
+}
+
+/*
+ * A ring of n vertices of a torus, around its tube at the angle whose cos
+ * and sin are cp and sp, cphi and sphi going around the tube
+ */
+void fgGeometryTorusRingScalar( GLfloat *vert, GLfloat *norm, const GLfloat *cphi, const GLfloat *sphi, int n,
+                                GLfloat cp, GLfloat sp, GLfloat iradius, GLfloat oradius )
+{
+    int i;
+
+    for( i=0; i<n; i++, vert+=3, norm+=3 )
+    {
+        const GLfloat r = oradius + cphi[i] * iradius;
+
+        vert[0] = cp * r ;
+        vert[1] = sp * r ;
+        vert[2] =      sphi[i] * iradius ;
+        norm[0] = cp * cphi[i] ;
+        norm[1] = sp * cphi[i] ;
+        norm[2] =      sphi[i] ;
+    }
+}
+
+void fgGeometryTorusRing( GLfloat *vert, GLfloat *norm, const GLfloat *cphi, const GLfloat *sphi, int n,
+                          GLfloat cp, GLfloat sp, GLfloat iradius, GLfloat oradius )
+{
+    int i = 0;
+
+#if defined(FGH_KERNELS_SSE2)
+    const __m128 vcp = _mm_set1_ps( cp ), vsp = _mm_set1_ps( sp );
+    const __m128 vi = _mm_set1_ps( iradius ), vo = _mm_set1_ps( oradius );
+
+    for( ; i+4<=n; i+=4, vert+=12, norm+=12 )
+    {
+        const __m128 c = _mm_loadu_ps( cphi+i ), s = _mm_loadu_ps( sphi+i );
+        const __m128 r = _mm_add_ps( vo, _mm_mul_ps( c, vi ) );
+
+        fghStoreTriplets4( vert, _mm_mul_ps( vcp, r ), _mm_mul_ps( vsp, r ), _mm_mul_ps( s, vi ) );
+        fghStoreTriplets4( norm, _mm_mul_ps( vcp, c ), _mm_mul_ps( vsp, c ), s );
+    }
+#elif defined(FGH_KERNELS_NEON)
+    for( ; i+4<=n; i+=4, vert+=12, norm+=12 )
+    {
+        const float32x4_t c = vld1q_f32( cphi+i ), s = vld1q_f32( sphi+i );
+        const float32x4_t r = vaddq_f32( vdupq_n_f32( oradius ), vmulq_n_f32( c, iradius ) );
+        float32x4x3_t v, nv;
+
+        v.val[0] = vmulq_n_f32( r, cp );
+        v.val[1] = vmulq_n_f32( r, sp );
+        v.val[2] = vmulq_n_f32( s, iradius );
+        nv.val[0] = vmulq_n_f32( c, cp );
+        nv.val[1] = vmulq_n_f32( c, sp );
+        nv.val[2] = s;
+        vst3q_f32( vert, v );
+        vst3q_f32( norm, nv );
+    }
+#endif
+
+    fgGeometryTorusRingScalar( vert, norm, cphi+i, sphi+i, n-i, cp, sp, iradius, oradius );
+}
+
+/* Which kernels fgGeometryRing() and co use */
+const char *fgGeometryKernelsISA( void )
+{
+#if defined(FGH_KERNELS_SSE2)
+    return "SSE2";
+#elif defined(FGH_KERNELS_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
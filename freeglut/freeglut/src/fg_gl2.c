@@ -39,7 +39,15 @@ FGH_PFNGLBUFFERDATAPROC fghBufferData;
 FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC fghEnableVertexAttribArray;
 FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC fghDisableVertexAttribArray;
 FGH_PFNGLVERTEXATTRIBPOINTERPROC fghVertexAttribPointer;
+FGH_PFNGLVERTEXATTRIB4FVPROC fghVertexAttrib4fv;
+FGH_PFNGLACTIVETEXTUREPROC fghActiveTexture;
+FGH_PFNGLCLIENTACTIVETEXTUREPROC fghClientActiveTexture;
 #endif
+FGH_PFNGLDRAWARRAYSINSTANCEDPROC fghDrawArraysInstanced;
+FGH_PFNGLDRAWELEMENTSINSTANCEDPROC fghDrawElementsInstanced;
+FGH_PFNGLVERTEXATTRIBDIVISORPROC fghVertexAttribDivisor;
+FGH_PFNGLMULTIDRAWARRAYSPROC fghMultiDrawArrays;
+FGH_PFNGLMULTIDRAWELEMENTSPROC fghMultiDrawElements;
 
 void FGAPIENTRY glutSetVertexAttribCoord3(GLint attrib) {
   if (fgStructure.CurrentWindow != NULL)
@@ -56,12 +64,151 @@ void FGAPIENTRY glutSetVertexAttribTexCoord2(GLint attrib) {
         fgStructure.CurrentWindow->Window.attribute_v_texture = attrib;
 }
 
+void FGAPIENTRY glutSetVertexAttribInstanceMatrix(GLint attrib) {
+    if (fgStructure.CurrentWindow != NULL)
+        fgStructure.CurrentWindow->Window.attribute_i_matrix = attrib;
+}
+
+void FGAPIENTRY glutSetVertexAttribInstanceColor(GLint attrib) {
+    if (fgStructure.CurrentWindow != NULL)
+        fgStructure.CurrentWindow->Window.attribute_i_color = attrib;
+}
+
+/*
+ * Check the version of the current context, as reported by GL_VERSION
+ * ("major.minor ..." or "OpenGL ES major.minor ...").
+ */
+GLboolean fghContextVersionAtLeast(int major, int minor, int majorES, int minorES)
+{
+    const char *version = (const char *)glGetString(GL_VERSION);
+    GLboolean isES;
+    int glMajor, glMinor;
+
+    if (!version)
+        return GL_FALSE;
+
+    isES = strncmp(version, "OpenGL ES", 9) == 0;
+    while (*version && (*version < '0' || *version > '9'))
+        version++;
+    if (sscanf(version, "%d.%d", &glMajor, &glMinor) != 2)
+        return GL_FALSE;
+
+    if (isES)
+        return glMajor > majorES || (glMajor == majorES && glMinor >= minorES);
+    return glMajor > major || (glMajor == major && glMinor >= minor);
+}
+
+/* Instanced drawing is optional, failing to find it is not an error */
+static void fghInitInstancing()
+{
+    fgState.HasInstancing = 0;
+    if (!fghContextVersionAtLeast(3, 3, 3, 0))
+        return;
+
+    fghDrawArraysInstanced = (FGH_PFNGLDRAWARRAYSINSTANCEDPROC)glutGetProcAddress("glDrawArraysInstanced");
+    fghDrawElementsInstanced = (FGH_PFNGLDRAWELEMENTSINSTANCEDPROC)glutGetProcAddress("glDrawElementsInstanced");
+    fghVertexAttribDivisor = (FGH_PFNGLVERTEXATTRIBDIVISORPROC)glutGetProcAddress("glVertexAttribDivisor");
+    fgState.HasInstancing = fghDrawArraysInstanced && fghDrawElementsInstanced && fghVertexAttribDivisor;
+}
+
+/* 32-bit vertex indices are core in OpenGL and OpenGL ES 3.0, and an
+   extension in OpenGL ES 1.x/2.0 */
+static void fghInitUintIndices()
+{
+    fgState.HasUintIndices = fghContextVersionAtLeast(1, 1, 3, 0) ||
+                             glutExtensionSupported("GL_OES_element_index_uint");
+}
+
+#ifndef GL_ES_VERSION_2_0
+/*
+ * Check whether the current context has the fixed function pipeline, which
+ * core and forward-compatible contexts lack.
+ */
+GLboolean fghContextHasFixedPipeline(void)
+{
+    GLint flags = 0, profile = 0;
+
+    if (!fghContextVersionAtLeast(3, 0, 0, 0))
+        return GL_TRUE;
+
+    glGetIntegerv(FGH_CONTEXT_FLAGS, &flags);
+    if (flags & FGH_CONTEXT_FLAG_FORWARD_COMPATIBLE_BIT)
+        return GL_FALSE;
+
+    if (fghContextVersionAtLeast(3, 2, 0, 0))
+    {
+        glGetIntegerv(FGH_CONTEXT_PROFILE_MASK, &profile);
+        if (profile & FGH_CONTEXT_CORE_PROFILE_BIT)
+            return GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
+/* Multi-draw is optional too, it lets fg_geometry draw all faces or loops
+   of a wire shape in one call */
+static void fghInitMultiDraw()
+{
+    fgState.HasMultiDraw = 0;
+    if (!fghContextVersionAtLeast(1, 4, 0, 0))
+        return;
+
+    fghMultiDrawArrays = (FGH_PFNGLMULTIDRAWARRAYSPROC)glutGetProcAddress("glMultiDrawArrays");
+    fghMultiDrawElements = (FGH_PFNGLMULTIDRAWELEMENTSPROC)glutGetProcAddress("glMultiDrawElements");
+    fgState.HasMultiDraw = fghMultiDrawArrays && fghMultiDrawElements;
+}
+
+/* The fixed function texture units and targets, for drawing with only a
+   known texture enabled, see fg_font.c */
+static void fghInitFixedTextures()
+{
+    GLint units = 1;
+
+    fghActiveTexture = NULL;
+    fghClientActiveTexture = NULL;
+    fgState.NumTextureUnits = 1;
+    fgState.HasTexture3D = 0;
+    fgState.HasTextureCubeMap = 0;
+    fgState.HasTextureRectangle = 0;
+    if (!fgState.HasFixedPipeline)
+        return;
+
+    fgState.HasTexture3D = fghContextVersionAtLeast(1, 2, 0, 0);
+    fgState.HasTextureCubeMap = fghContextVersionAtLeast(1, 3, 0, 0);
+    fgState.HasTextureRectangle = fghContextVersionAtLeast(3, 1, 0, 0) ||
+                                  glutExtensionSupported("GL_ARB_texture_rectangle") ||
+                                  glutExtensionSupported("GL_NV_texture_rectangle");
+    if (!fgState.HasTextureCubeMap)
+        return;
+
+    fghActiveTexture = (FGH_PFNGLACTIVETEXTUREPROC)glutGetProcAddress("glActiveTexture");
+    fghClientActiveTexture = (FGH_PFNGLCLIENTACTIVETEXTUREPROC)glutGetProcAddress("glClientActiveTexture");
+    if (!fghActiveTexture || !fghClientActiveTexture)
+    {
+        fghActiveTexture = NULL;
+        fghClientActiveTexture = NULL;
+        return;
+    }
+    glGetIntegerv(FGH_MAX_TEXTURE_UNITS, &units);
+    fgState.NumTextureUnits = units > 1 ? units : 1;
+}
+#endif
+
 void fgInitGL2() {
+    fghInitUintIndices();
 #ifdef GL_ES_VERSION_2_0
     fgState.HasOpenGL20 = (fgState.MajorVersion >= 2);
+    /* OpenGL ES 2.0 dropped the fixed function pipeline */
+    fgState.HasFixedPipeline = !fgState.HasOpenGL20;
+    if (fgState.HasOpenGL20)
+        fghInitInstancing();
 #else
     /* TODO: Mesa returns a valid stub function, rather than NULL,
        when we request a non-existent function */
+    fgState.HasFixedPipeline = fghContextHasFixedPipeline();
+    fghInitMultiDraw();
+    fghInitFixedTextures();
+
 #define CHECK(func, a) if ((a) == NULL) { fgWarning("fgInitGL2: " func " is NULL"); return; }
     CHECK("fghGenBuffers", fghGenBuffers = (FGH_PFNGLGENBUFFERSPROC)glutGetProcAddress("glGenBuffers"));
     CHECK("fghDeleteBuffers", fghDeleteBuffers = (FGH_PFNGLDELETEBUFFERSPROC)glutGetProcAddress("glDeleteBuffers"));
@@ -70,7 +217,9 @@ void fgInitGL2() {
     CHECK("fghVertexAttribPointer", fghVertexAttribPointer = (FGH_PFNGLVERTEXATTRIBPOINTERPROC)glutGetProcAddress("glVertexAttribPointer"));
     CHECK("fghEnableVertexAttribArray", fghEnableVertexAttribArray = (FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC)glutGetProcAddress("glEnableVertexAttribArray"));
     CHECK("fghDisableVertexAttribArray", fghDisableVertexAttribArray = (FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC)glutGetProcAddress("glDisableVertexAttribArray"));
+    CHECK("fghVertexAttrib4fv", fghVertexAttrib4fv = (FGH_PFNGLVERTEXATTRIB4FVPROC)glutGetProcAddress("glVertexAttrib4fv"));
 #undef CHECK
     fgState.HasOpenGL20 = 1;
+    fghInitInstancing();
 #endif
 }
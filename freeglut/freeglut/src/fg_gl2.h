@@ -34,6 +34,7 @@
 
 #define FGH_ARRAY_BUFFER GL_ARRAY_BUFFER
 #define FGH_STATIC_DRAW GL_STATIC_DRAW
+#define FGH_STREAM_DRAW GL_STREAM_DRAW
 #define FGH_ELEMENT_ARRAY_BUFFER GL_ELEMENT_ARRAY_BUFFER
 
 #define fghGenBuffers glGenBuffers
@@ -43,6 +44,7 @@
 #define fghEnableVertexAttribArray glEnableVertexAttribArray
 #define fghDisableVertexAttribArray glDisableVertexAttribArray
 #define fghVertexAttribPointer glVertexAttribPointer
+#define fghVertexAttrib4fv glVertexAttrib4fv
 
 #else
 /* Load functions dynamically, they are not defined in e.g. win32's
@@ -56,7 +58,18 @@
    libraries like GLEW or the GL/glext.h header */
 #define FGH_ARRAY_BUFFER 0x8892
 #define FGH_STATIC_DRAW 0x88E4
+#define FGH_STREAM_DRAW 0x88E0
 #define FGH_ELEMENT_ARRAY_BUFFER 0x8893
+#define FGH_R8 0x8229
+#define FGH_CONTEXT_FLAGS 0x821E
+#define FGH_CONTEXT_FLAG_FORWARD_COMPATIBLE_BIT 0x0001
+#define FGH_CONTEXT_PROFILE_MASK 0x9126
+#define FGH_CONTEXT_CORE_PROFILE_BIT 0x0001
+#define FGH_TEXTURE_3D 0x806F
+#define FGH_TEXTURE_CUBE_MAP 0x8513
+#define FGH_TEXTURE_RECTANGLE 0x84F5
+#define FGH_TEXTURE0 0x84C0
+#define FGH_MAX_TEXTURE_UNITS 0x84E2
 
 typedef int fghGLsizeiptr;
 typedef void (APIENTRY *FGH_PFNGLGENBUFFERSPROC) (GLsizei n, GLuint *buffers);
@@ -66,6 +79,9 @@ typedef void (APIENTRY *FGH_PFNGLDELETEBUFFERSPROC) (GLsizei n, const GLuint* bu
 typedef void (APIENTRY *FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC) (GLuint index);
 typedef void (APIENTRY *FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC) (GLuint);
 typedef void (APIENTRY *FGH_PFNGLVERTEXATTRIBPOINTERPROC) (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid *pointer);
+typedef void (APIENTRY *FGH_PFNGLVERTEXATTRIB4FVPROC) (GLuint index, const GLfloat *v);
+typedef void (APIENTRY *FGH_PFNGLACTIVETEXTUREPROC) (GLenum texture);
+typedef void (APIENTRY *FGH_PFNGLCLIENTACTIVETEXTUREPROC) (GLenum texture);
 
 extern FGH_PFNGLGENBUFFERSPROC fghGenBuffers;
 extern FGH_PFNGLDELETEBUFFERSPROC fghDeleteBuffers;
@@ -74,9 +90,41 @@ extern FGH_PFNGLBUFFERDATAPROC fghBufferData;
 extern FGH_PFNGLENABLEVERTEXATTRIBARRAYPROC fghEnableVertexAttribArray;
 extern FGH_PFNGLDISABLEVERTEXATTRIBARRAYPROC fghDisableVertexAttribArray;
 extern FGH_PFNGLVERTEXATTRIBPOINTERPROC fghVertexAttribPointer;
+extern FGH_PFNGLVERTEXATTRIB4FVPROC fghVertexAttrib4fv;
+
+/* Multitexturing (OpenGL 1.3), NULL without it, see fgState.NumTextureUnits */
+extern FGH_PFNGLACTIVETEXTUREPROC fghActiveTexture;
+extern FGH_PFNGLCLIENTACTIVETEXTUREPROC fghClientActiveTexture;
 
 #    endif
 
+/* Instanced drawing is only core since OpenGL 3.3 and OpenGL ES 3.0, so
+   these are always loaded dynamically and may be unavailable, see
+   fgState.HasInstancing */
+#ifndef APIENTRY
+#    define APIENTRY
+#endif
+
+typedef void (APIENTRY *FGH_PFNGLDRAWARRAYSINSTANCEDPROC) (GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+typedef void (APIENTRY *FGH_PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei instancecount);
+typedef void (APIENTRY *FGH_PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+
+extern FGH_PFNGLDRAWARRAYSINSTANCEDPROC fghDrawArraysInstanced;
+extern FGH_PFNGLDRAWELEMENTSINSTANCEDPROC fghDrawElementsInstanced;
+extern FGH_PFNGLVERTEXATTRIBDIVISORPROC fghVertexAttribDivisor;
+
+/* Multi-draw (OpenGL 1.4, not in OpenGL ES), also used for OpenGL 1.1
+   style drawing, see fgState.HasMultiDraw */
+typedef void (APIENTRY *FGH_PFNGLMULTIDRAWARRAYSPROC) (GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawcount);
+typedef void (APIENTRY *FGH_PFNGLMULTIDRAWELEMENTSPROC) (GLenum mode, const GLsizei *count, GLenum type, const GLvoid *const *indices, GLsizei drawcount);
+
+extern FGH_PFNGLMULTIDRAWARRAYSPROC fghMultiDrawArrays;
+extern FGH_PFNGLMULTIDRAWELEMENTSPROC fghMultiDrawElements;
+
 extern void fgInitGL2();
+extern GLboolean fghContextVersionAtLeast(int major, int minor, int majorES, int minorES);
+#ifndef GL_ES_VERSION_2_0
+extern GLboolean fghContextHasFixedPipeline(void);
+#endif
 
 #endif
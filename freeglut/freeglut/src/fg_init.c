@@ -66,9 +66,20 @@ SFG_State fgState = { { -1, -1, GL_FALSE },  /* Position */
                       0,                     /* FPSInterval */
                       0,                     /* SwapCount */
                       0,                     /* SwapTime */
+                      GL_FALSE,              /* StartupTiming */
+                      0,                     /* StartupMark */
                       0,                     /* Time */
-                      { NULL, NULL },         /* Timers */
+                      NULL,                   /* Timers */
+                      0,                      /* NumTimers */
+                      0,                      /* TimersSize */
+                      0,                      /* TimerSequence */
+                      { { NULL, NULL } },     /* TimerIDs */
                       { NULL, NULL },         /* FreeTimers */
+                      NULL,                   /* InputFds */
+                      0,                      /* NumInputFds */
+                      0,                      /* InputFdsSize */
+                      NULL,                   /* InputFdSlots */
+                      0,                      /* InputFdSlotsSize */
                       NULL,                   /* IdleCallback */
                       NULL,                   /* IdleCallbackData */
                       0,                      /* ActiveMenus */
@@ -91,11 +102,28 @@ SFG_State fgState = { { -1, -1, GL_FALSE },  /* Position */
                       GL_FALSE,               /* SkipStaleMotion */
                       GL_FALSE,               /* StrokeFontDrawJoinDots */
                       GL_FALSE,               /* AllowNegativeWindowPosition */
+                      FREEGLUT_SHAPE_CACHE_MEMORY, /* ShapeCacheMemory */
+                      0,                      /* ShapeCacheHits */
+                      0,                      /* ShapeCacheMisses */
+                      GL_FALSE,               /* BitmapFontAtlas */
+                      GL_FALSE,               /* BatchedRedraw */
+                      GL_FALSE,               /* CoalesceEvents */
+                      8,                      /* TeasetSolidSubdivs */
+                      10,                     /* TeasetWireSubdivs */
+                      GL_FALSE,               /* AuthoritativeGeometry */
                       1,                      /* OpenGL context MajorVersion */
                       0,                      /* OpenGL context MinorVersion */
                       0,                      /* OpenGL ContextFlags */
                       0,                      /* OpenGL ContextProfile */
                       0,                      /* HasOpenGL20 */
+                      0,                      /* HasInstancing */
+                      0,                      /* HasMultiDraw */
+                      0,                      /* HasUintIndices */
+                      1,                      /* HasFixedPipeline */
+                      1,                      /* NumTextureUnits */
+                      0,                      /* HasTexture3D */
+                      0,                      /* HasTextureCubeMap */
+                      0,                      /* HasTextureRectangle */
                       NULL,                   /* ErrorFunc */
                       NULL,                   /* ErrorFuncData */
                       NULL,                   /* WarningFunc */
@@ -131,6 +159,10 @@ void fghParseCommandLineArguments ( int* pargc, char** argv, char **pDisplayName
         }
     }
 
+    /* check if GLUT_STARTUP_TIMING env var is set */
+    if( getenv( "GLUT_STARTUP_TIMING" ) )
+        fgState.StartupTiming = GL_TRUE;
+
     *pDisplayName = getenv( "DISPLAY" );
 
     for( i = 1; i < argc; i++ )
@@ -228,8 +260,6 @@ void fghCloseInputDevices ( void )
  */
 void fgDeinitialize( void )
 {
-    SFG_Timer *timer;
-
     if( !fgState.Initialised )
     {
         return;
@@ -250,17 +280,15 @@ void fgDeinitialize( void )
 
     fgDestroyStructure( );
 
-    while( ( timer = fgState.Timers.First) )
-    {
-        fgListRemove( &fgState.Timers, &timer->Node );
-        free( timer );
-    }
+    fgDestroyShapeCache( );
 
-    while( ( timer = fgState.FreeTimers.First) )
-    {
-        fgListRemove( &fgState.FreeTimers, &timer->Node );
-        free( timer );
-    }
+    fgDestroyStrokeFonts( );
+
+    fgDestroyTimers( );
+
+    fgDestroyAsyncCalls( );
+
+    fgDestroyInputFds( );
 
     fgPlatformDeinitialiseInputDevices ();
 
@@ -299,9 +327,6 @@ void fgDeinitialize( void )
     fgState.GameModeDepth   = -1;
     fgState.GameModeRefresh = -1;
 
-    fgListInit( &fgState.Timers );
-    fgListInit( &fgState.FreeTimers );
-
     fgState.IdleCallback           = ( FGCBIdleUC )NULL;
     fgState.IdleCallbackData       = NULL;
     fgState.MenuStateCallback      = ( FGCBMenuState )NULL;
@@ -311,6 +336,7 @@ void fgDeinitialize( void )
     fgState.SwapCount   = 0;
     fgState.SwapTime    = 0;
     fgState.FPSInterval = 0;
+    fgState.StartupTiming = GL_FALSE;
 
     if( fgState.ProgramName )
     {
@@ -329,6 +355,25 @@ void fgDeinitialize( void )
 #   include "util/xparsegeometry_repl.h"
 #endif
 
+/*
+ * With the GLUT_STARTUP_TIMING env var set, print how long the startup
+ * phase ending now took, up to the first window being shown. A NULL phase
+ * just starts the clock.
+ */
+void fgStartupPhase( const char *phase )
+{
+    fg_time_t now;
+
+    if( !fgState.StartupTiming )
+        return;
+
+    now = fgSystemTime();
+    if( phase )
+        fprintf( stderr, "freeglut: %s took %.3f ms\n",
+                 phase, 0.001 * ( double )( now - fgState.StartupMark ) );
+    fgState.StartupMark = now;
+}
+
 /*
  * Perform initialization. This usually happens on the program startup
  * and restarting after glutMainLoop termination...
@@ -349,8 +394,12 @@ void FGAPIENTRY glutInit( int* pargc, char** argv )
     }
 
     fgCreateStructure( );
+#ifndef NDEBUG
+    fgCheckGLUTProcs( );
+#endif
 
     fghParseCommandLineArguments ( pargc, argv, &displayName, &geometry );
+    fgStartupPhase( NULL );
 
     /*
      * Have the display created now. If there wasn't a "-display"
@@ -358,6 +407,7 @@ void FGAPIENTRY glutInit( int* pargc, char** argv )
      * variable for opening the X display (see code above):
      */
     fgPlatformInitialize( displayName );
+    fgStartupPhase( "rest of fgPlatformInitialize" );
 
     /*
      * Geometry parsing deferred until here because we may need the screen
@@ -386,6 +436,8 @@ void FGAPIENTRY glutInit( int* pargc, char** argv )
         if( (mask & (XValue|YValue)) == (XValue|YValue) )
             fgState.Position.Use = GL_TRUE;
     }
+
+    fgStartupPhase( "rest of glutInit" );
 }
 
 /*
@@ -106,6 +106,11 @@
 /* -- FIXED CONFIGURATION LIMITS ------------------------------------------- */
 
 #define  FREEGLUT_MAX_MENUS            3
+#define  FREEGLUT_GEOMETRY_CACHE_SIZE  64   /* Shapes kept in GPU buffers per context */
+#define  FREEGLUT_SHAPE_CACHE_MEMORY   (4*1024*1024)    /* Default bytes of tessellated shapes kept in memory */
+#define  FREEGLUT_TIMER_ID_BUCKETS     64   /* Hash buckets for looking up timers by ID */
+#define  FREEGLUT_NUM_BITMAP_FONTS     7    /* The GLUT_BITMAP_* fonts */
+#define  FREEGLUT_MAX_TEASET_SUBDIV    256  /* Bounds the teaset's memory use, about 120MB for the teapot */
 
 /* These files should be available on every platform. */
 #include <stdio.h>
@@ -171,7 +176,7 @@
 /* General defines */
 #define INVALID_MODIFIERS 0xffffffff
 
-/* FreeGLUT internal time type */
+/* FreeGLUT internal time type, in microseconds */
 #if defined(HAVE_STDINT_H)
 #   include <stdint.h>
     typedef uint64_t fg_time_t;
@@ -292,6 +297,8 @@ typedef void (* FGCBIdle            )( void );
 typedef void (* FGCBIdleUC          )( FGCBUserData );
 typedef void (* FGCBTimer           )( int );
 typedef void (* FGCBTimerUC         )( int, FGCBUserData );
+typedef void (* FGCBInputFd         )( int, int );
+typedef void (* FGCBInputFdUC       )( int, int, FGCBUserData );
 typedef void (* FGCBMenuState       )( int );
 typedef void (* FGCBMenuStatus      )( int, int, int );
 typedef void (* FGCBMenuStatusUC    )( int, int, int, FGCBUserData );
@@ -342,6 +349,30 @@ typedef enum
   GLUT_EXEC_STATE_STOP
 } fgExecutionState ;
 
+/* The user can create any number of timer hooks */
+typedef struct tagSFG_Timer SFG_Timer;
+struct tagSFG_Timer
+{
+    SFG_Node        Node;               /* In an ID bucket while pending, else in FreeTimers */
+    int             ID;                 /* The timer ID integer              */
+    FGCBTimerUC     Callback;           /* The timer callback                */
+    FGCBUserData    CallbackData;       /* The timer callback user data      */
+    fg_time_t       TriggerTime;        /* The timer trigger time            */
+    unsigned long   Sequence;           /* Order of registration             */
+    int             HeapIndex;          /* Position in fgState.Timers        */
+    GLboolean       Internal;           /* Queued by freeglut itself, glutCancelTimer skips it */
+};
+
+/* The user can have the main loop wait on their own descriptors too */
+typedef struct tagSFG_InputFd SFG_InputFd;
+struct tagSFG_InputFd
+{
+    int             Fd;                 /* The descriptor                    */
+    int             Events;             /* GLUT_INPUT_READABLE and/or _WRITABLE */
+    FGCBInputFdUC   Callback;           /* The descriptor callback           */
+    FGCBUserData    CallbackData;       /* The descriptor callback user data */
+};
+
 /* This structure holds different freeglut settings */
 typedef struct tagSFG_State SFG_State;
 struct tagSFG_State
@@ -366,10 +397,21 @@ struct tagSFG_State
     GLuint           FPSInterval;          /* Interval between FPS printfs   */
     GLuint           SwapCount;            /* Count of glutSwapBuffer calls  */
     GLuint           SwapTime;             /* Time of last SwapBuffers       */
+    GLboolean        StartupTiming;        /* Report startup phase times?    */
+    fg_time_t        StartupMark;          /* End of the last startup phase  */
 
     fg_time_t        Time;                 /* Time that glutInit was called  */
-    SFG_List         Timers;               /* The freeglut timer hooks       */
+    SFG_Timer      **Timers;               /* The freeglut timer hooks, a binary heap on trigger time */
+    int              NumTimers;            /* Number of timers in the heap   */
+    int              TimersSize;           /* Allocated size of the heap     */
+    unsigned long    TimerSequence;        /* Registration count, for FIFO order of timers with equal trigger times */
+    SFG_List         TimerIDs[ FREEGLUT_TIMER_ID_BUCKETS ]; /* Pending timers hashed by ID */
     SFG_List         FreeTimers;           /* The unused timer hooks         */
+    SFG_InputFd     *InputFds;             /* The descriptors from glutAddInputFd */
+    int              NumInputFds;          /* Number of those descriptors    */
+    int              InputFdsSize;         /* Allocated size of InputFds     */
+    int             *InputFdSlots;         /* InputFds index by descriptor, -1 if none */
+    int              InputFdSlotsSize;     /* Allocated size of InputFdSlots */
 
     FGCBIdleUC       IdleCallback;         /* The global idle callback       */
     FGCBUserData     IdleCallbackData;     /* The global idle callback data  */
@@ -402,11 +444,29 @@ struct tagSFG_State
     GLboolean        StrokeFontDrawJoinDots;/* Draw dots between line segments of stroke fonts? */
     GLboolean        AllowNegativeWindowPosition; /* GLUT, by default, doesn't allow negative window positions. Enable it? */
 
+    int              ShapeCacheMemory;     /* Max. bytes of tessellated shapes kept in memory */
+    int              ShapeCacheHits;       /* Shapes drawn from the tessellation cache */
+    int              ShapeCacheMisses;     /* Shapes that had to be tessellated */
+    GLboolean        BitmapFontAtlas;      /* Draw bitmap fonts from textures instead of glBitmap? */
+    GLboolean        BatchedRedraw;        /* Redraw windows grouped by context? */
+    GLboolean        CoalesceEvents;       /* Drop motion, configure and expose events superseded by later ones? */
+    int              TeasetSolidSubdivs;   /* Vertices along each side of a solid teaset patch */
+    int              TeasetWireSubdivs;    /* Same, for the wire teaset */
+    GLboolean        AuthoritativeGeometry;/* Query the window system for window geometry instead of tracking it? */
+
     int              MajorVersion;         /* Major OpenGL context version  */
     int              MinorVersion;         /* Minor OpenGL context version  */
     int              ContextFlags;         /* OpenGL context flags          */
     int              ContextProfile;       /* OpenGL context profile        */
     int              HasOpenGL20;          /* fgInitGL2 could find all OpenGL 2.0 functions */
+    int              HasInstancing;        /* fgInitGL2 could find the OpenGL 3.3/ES 3.0 instanced drawing functions */
+    int              HasMultiDraw;         /* fgInitGL2 could find glMultiDrawArrays/Elements */
+    int              HasUintIndices;       /* Context can draw with GL_UNSIGNED_INT vertex indices */
+    int              HasFixedPipeline;     /* Context has the fixed function pipeline (matrix stacks etc) */
+    int              NumTextureUnits;      /* Fixed function texture units, 1 without multitexturing */
+    int              HasTexture3D;         /* Context has the GL_TEXTURE_3D target */
+    int              HasTextureCubeMap;    /* Context has the GL_TEXTURE_CUBE_MAP target */
+    int              HasTextureRectangle;  /* Context has the GL_TEXTURE_RECTANGLE target */
     FGErrorUC        ErrorFunc;            /* User defined error handler    */
     FGCBUserData     ErrorFuncData;        /* User defined error handler user data */
     FGWarningUC      WarningFunc;          /* User defined warning handler  */
@@ -426,15 +486,84 @@ struct tagSFG_Display
 };
 
 
-/* The user can create any number of timer hooks */
-typedef struct tagSFG_Timer SFG_Timer;
-struct tagSFG_Timer
+/*
+ * The shapes of fg_geometry.c and fg_teapot.c that can be kept in
+ * persistent vertex and index buffers, used to key the per-context
+ * geometry cache.
+ */
+typedef enum
+{
+    FG_SHAPE_CUBE,
+    FG_SHAPE_DODECAHEDRON,
+    FG_SHAPE_ICOSAHEDRON,
+    FG_SHAPE_OCTAHEDRON,
+    FG_SHAPE_RHOMBICDODECAHEDRON,
+    FG_SHAPE_TETRAHEDRON,
+    FG_SHAPE_SIERPINSKISPONGE,
+    FG_SHAPE_SPHERE,
+    FG_SHAPE_CONE,
+    FG_SHAPE_CYLINDER,
+    FG_SHAPE_TORUS,
+    FG_SHAPE_TEAPOT,
+    FG_SHAPE_TEACUP,
+    FG_SHAPE_TEASPOON
+} fgShape;
+
+/* Identifies one generated shape: which one, its parameters and wire/solid */
+typedef struct tagSFG_GeometryKey SFG_GeometryKey;
+struct tagSFG_GeometryKey
+{
+    fgShape         Shape;              /* The shape that was generated      */
+    GLboolean       Wire;               /* Wire or solid version?            */
+    double          Params[5];          /* Size, subdivisions, etc; 0 if unused */
+};
+
+/*
+ * Vertex and index buffers holding one shape on the GPU, along with what
+ * is needed to draw them. Kept in a per-context list, most recently used
+ * first, so repeated draws of the same shape need not upload again.
+ */
+typedef struct tagSFG_GeometryBuffers SFG_GeometryBuffers;
+struct tagSFG_GeometryBuffers
 {
     SFG_Node        Node;
-    int             ID;                 /* The timer ID integer              */
-    FGCBTimerUC     Callback;           /* The timer callback                */
-    FGCBUserData    CallbackData;       /* The timer callback user data      */
-    fg_time_t       TriggerTime;        /* The timer trigger time            */
+    SFG_GeometryKey Key;
+
+    GLuint          Vbo;                /* Interleaved coordinates, normals and texture coordinates, see fghUploadGeometry20 */
+    GLboolean       HasTextcs;          /* Texture coordinates in Vbo?       */
+    GLuint          IboElements;        /* Vertex indices, if any            */
+    GLuint          IboElements2;       /* Second index set (wire mode only) */
+    GLenum          IdxType;            /* GL_UNSIGNED_SHORT or GL_UNSIGNED_INT */
+
+    GLsizei         NumVertices;
+    GLsizei         NumParts, NumVertPerPart;   /* see fghDrawGeometryWire/Solid */
+    GLenum          VertexMode;
+    GLsizei         NumParts2, NumVertPerPart2;
+};
+
+/*
+ * A shape tessellated at unit size, kept in the tessellation cache of
+ * fg_geometry.c and scaled to the requested size when drawn.
+ */
+typedef struct tagSFG_Mesh SFG_Mesh;
+struct tagSFG_Mesh
+{
+    SFG_Node   Node;
+    fgShape    Shape;
+    GLboolean  Wire;
+    GLfloat    Param;               /* shape parameter left after normalization */
+    GLint      Subdiv1, Subdiv2;    /* slices and stacks, or sides and rings */
+    GLboolean  Cached;              /* In shapeCache, else freed after drawing */
+    size_t     Size;                /* Bytes used by this mesh */
+
+    GLfloat   *Vertices, *Normals;
+    GLfloat   *Textcs;              /* Texture coordinates, solid teaset only */
+    int        NumVertices;
+    GLenum     IdxType;             /* GL_UNSIGNED_SHORT or GL_UNSIGNED_INT */
+    GLvoid    *VertIdxs, *VertIdxs2;
+    GLsizei    NumParts, NumVertPerPart;    /* see fghDrawGeometryWire/Solid */
+    GLenum     VertexMode;
+    GLsizei    NumParts2, NumVertPerPart2;
 };
 
 /*
@@ -458,6 +587,23 @@ struct tagSFG_Context
     GLint           attribute_v_coord;
     GLint           attribute_v_normal;
     GLint           attribute_v_texture;
+
+    /* Same for instanced drawing: the first of four attributes receiving
+     * the columns of the per-instance transform, and the per-instance color
+     */
+    GLint           attribute_i_matrix;
+    GLint           attribute_i_color;
+
+    /* Shapes already uploaded to buffers in this context, see fg_geometry.c */
+    SFG_List        GeometryCache;
+    int             GeometryCacheSize;
+    GLuint          InstanceBuffers[2]; /* Per-instance transforms and colors */
+
+    /* Glyph atlases of the bitmap fonts, see fg_font.c */
+    GLuint          FontTextures[ FREEGLUT_NUM_BITMAP_FONTS ];
+    GLuint          FontBuffer;         /* Bitmap font quads and stroke font strips */
+    GLfloat         StrokePenX;         /* Where the next stroke character goes  */
+    GLfloat         StrokePenY;         /* without the fixed function pipeline   */
 };
 
 
@@ -538,8 +684,9 @@ struct tagSFG_WindowState   /* as per notes above, sizes always refer to the cli
 
     SFG_PlatformWindowState pWState;    /* Window width/height (X11) or rectangle/style (Windows) from before a resize, and other stuff only needed on specific platforms */
 
-    long            JoystickPollRate;   /* The joystick polling rate         */
-    fg_time_t       JoystickLastPoll;   /* When the last poll happened       */
+    long            JoystickPollRate;   /* The joystick polling rate (msec)  */
+    fg_time_t       JoystickLastPoll;   /* When the last poll was due        */
+    SFG_Timer      *JoystickTimer;      /* The pending poll, if any          */
 
     int             MouseX, MouseY;     /* The most recent mouse position    */
 
@@ -740,6 +887,14 @@ struct tagSFG_MenuContext
 
 /* This structure describes a menu */
 typedef struct tagSFG_Window SFG_Window;
+
+/* A linked list structure of windows */
+typedef struct tagSFG_WindowList SFG_WindowList ;
+struct tagSFG_WindowList
+{
+    SFG_Node node;
+    SFG_Window *window ;
+};
 typedef struct tagSFG_MenuEntry SFG_MenuEntry;
 typedef struct tagSFG_Menu SFG_Menu;
 struct tagSFG_Menu
@@ -799,17 +954,13 @@ struct tagSFG_Window
     SFG_List            Children;               /* The subwindows d.l. list  */
 
     GLboolean           IsMenu;                 /* Set to 1 if we are a menu */
-};
-
 
-/* A linked list structure of windows */
-typedef struct tagSFG_WindowList SFG_WindowList ;
-struct tagSFG_WindowList
-{
-    SFG_Node node;
-    SFG_Window *window ;
+    SFG_WindowList      WorkEntry;              /* In fgStructure.WorkList if window is set */
+    unsigned int        WorkPass;               /* fgStructure.WorkPass when queued */
+    SFG_WindowList      RedrawEntry;            /* In fgStructure.RedrawList if window is set */
 };
 
+
 /* This holds information about all the windows, menus etc. */
 typedef struct tagSFG_Structure SFG_Structure;
 struct tagSFG_Structure
@@ -817,6 +968,9 @@ struct tagSFG_Structure
     SFG_List        Windows;         /* The global windows list            */
     SFG_List        Menus;           /* The global menus list              */
     SFG_List        WindowsToDestroy;
+    SFG_List        WorkList;        /* Windows with pending work          */
+    unsigned int    WorkPass;        /* Counts fghProcessWork() passes      */
+    SFG_List        RedrawList;      /* Windows to redraw, see GLUT_BATCHED_REDRAW */
 
     SFG_Window*     CurrentWindow;   /* The currently set window          */
     SFG_Menu*       CurrentMenu;     /* Same, but menu...                 */
@@ -1055,6 +1209,8 @@ void        fgOpenWindow( SFG_Window* window, const char* title,
                           GLboolean gameMode, GLboolean isSubWindow );
 void        fgCloseWindow( SFG_Window* window );
 void        fgAddToWindowDestroyList ( SFG_Window* window );
+void        fgAddToWindowWorkList( SFG_Window* window, unsigned int workMask );
+void        fgRemoveFromWindowWorkList( SFG_Window* window );
 void        fgCloseWindows ();
 void        fgDestroyWindow( SFG_Window* window );
 
@@ -1067,6 +1223,8 @@ int         fgJoystickDetect( void );
 void        fgInitialiseJoysticks( void );
 void        fgJoystickClose( void );
 void        fgJoystickPollWindow( SFG_Window* window );
+void        fgJoystickUpdateTimer( SFG_Window* window );
+void        fgJoystickCancelTimer( SFG_Window* window );
 
 /* InputDevice Initialisation and Closure */
 int         fgInputDeviceDetect( void );
@@ -1081,6 +1239,21 @@ void        fgSpaceballSetWindow( SFG_Window *window );
 int         fgHasSpaceball( void );
 int         fgSpaceballNumButtons( void );
 
+/* Release the shape buffers kept for a window's context, see fg_geometry.c */
+void        fgDestroyGeometryCache( SFG_Window *window );
+void        fgDestroyFontTextures( SFG_Window *window );
+void        fgDestroyStrokeFonts( void );
+void        fgTrimShapeCache( int maxBytes );
+void        fgDestroyShapeCache( void );
+
+/* Mesh generation inner loops, SIMD where available, see fg_geometry_kernels.c */
+void        fgGeometryRing( GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+                            GLfloat r, GLfloat z, GLfloat nScale, GLfloat nz );
+void        fgGeometrySphereRow( GLfloat *vert, GLfloat *norm, const GLfloat *cost, const GLfloat *sint, int n,
+                                 GLfloat s, GLfloat z, GLfloat radius );
+void        fgGeometryTorusRing( GLfloat *vert, GLfloat *norm, const GLfloat *cphi, const GLfloat *sphi, int n,
+                                 GLfloat cp, GLfloat sp, GLfloat iradius, GLfloat oradius );
+
 /* Setting the cursor for a given window */
 void fgSetCursor ( SFG_Window *window, int cursorID );
 
@@ -1142,12 +1315,33 @@ void fgDeactivateMenu( SFG_Window *window );
  */
 void fgDisplayMenu( void );
 
-/* Elapsed time as per glutGet(GLUT_ELAPSED_TIME). */
+/* Elapsed time as per glutGet(GLUT_ELAPSED_TIME_US). */
 fg_time_t fgElapsedTime( void );
 
-/* System time in milliseconds */
+/* System time in microseconds */
 fg_time_t fgSystemTime(void);
 
+/* GLUT_STARTUP_TIMING env var support, defined in fg_init.c */
+void fgStartupPhase( const char *phase );
+
+/* Checks the glutGetProcAddress table is sorted, defined in fg_ext.c */
+void fgCheckGLUTProcs( void );
+
+/* Timer queue functions, defined in fg_main.c */
+SFG_Timer *fgNewTimer( void );
+void fgAddTimer( SFG_Timer *timer );
+void fgRemoveTimer( SFG_Timer *timer );
+void fgDestroyTimers( void );
+
+/* Calls queued by other threads, defined in fg_main.c */
+void fgDestroyAsyncCalls( void );
+
+/* Application descriptor functions, defined in fg_main.c */
+GLboolean fgAddInputFd( int fd, int events, FGCBInputFdUC callback, FGCBUserData userData );
+void fgRemoveInputFd( int fd );
+void fgDispatchInputFd( int fd, int events );
+void fgDestroyInputFds( void );
+
 /* List functions */
 void fgListInit(SFG_List *list);
 void fgListAppend(SFG_List *list, SFG_Node *node);
@@ -713,6 +713,84 @@ void fgJoystickPollWindow( SFG_Window* window )
     }
 }
 
+/*
+ * Queues the next poll of a window's joystick, due at the given time
+ */
+static void fghJoystickTimer( int unused, FGCBUserData userData );
+static void fghQueueJoystickTimer( SFG_Window* window, fg_time_t triggerTime )
+{
+    SFG_Timer *timer = fgNewTimer( );
+
+    timer->Callback     = fghJoystickTimer;
+    timer->CallbackData = window;
+    timer->ID           = window->ID;
+    timer->TriggerTime  = triggerTime;
+    timer->Internal     = GL_TRUE;
+    fgAddTimer( timer );
+
+    window->State.JoystickLastPoll = triggerTime;
+    window->State.JoystickTimer    = timer;
+}
+
+/*
+ * Timer callback polling a window's joystick. The next poll is due one
+ * polling interval after this one was, so the rate doesn't drift with
+ * the main loop's latency.
+ */
+static void fghJoystickTimer( int unused, FGCBUserData userData )
+{
+    SFG_Window *window = ( SFG_Window * )userData;
+    fg_time_t next, now;
+
+    /* The timer is already off the queue */
+    window->State.JoystickTimer = NULL;
+
+#if !defined(_WIN32_WCE)
+    fgJoystickPollWindow( window );
+#endif /* !defined(_WIN32_WCE) */
+
+    /* The callback may have changed the polling rate, or disabled itself */
+    if( window->State.JoystickTimer ||
+        window->State.JoystickPollRate <= 0 || !FETCH_WCB( *window, Joystick ) )
+        return;
+
+    next = window->State.JoystickLastPoll +
+           (fg_time_t)window->State.JoystickPollRate * 1000;
+    now = fgElapsedTime( );
+    if( next <= now )
+        /* We fell behind by a whole interval, don't try to catch up */
+        next = now + (fg_time_t)window->State.JoystickPollRate * 1000;
+
+    fghQueueJoystickTimer( window, next );
+}
+
+/*
+ * Makes the window's polling timer agree with its joystick callback and
+ * polling rate: polls are queued as soon as both are set, starting now.
+ */
+void fgJoystickUpdateTimer( SFG_Window* window )
+{
+    if( window->State.JoystickPollRate > 0 && FETCH_WCB( *window, Joystick ) )
+    {
+        if( !window->State.JoystickTimer )
+            fghQueueJoystickTimer( window, fgElapsedTime( ) );
+    }
+    else
+        fgJoystickCancelTimer( window );
+}
+
+/*
+ * Removes a window's pending poll from the timer queue
+ */
+void fgJoystickCancelTimer( SFG_Window* window )
+{
+    if( window->State.JoystickTimer )
+    {
+        fgRemoveTimer( window->State.JoystickTimer );
+        window->State.JoystickTimer = NULL;
+    }
+}
+
 /*
  * Implementation for glutDeviceGet(GLUT_HAS_JOYSTICK)
  */
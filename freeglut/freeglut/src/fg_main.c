@@ -47,7 +47,14 @@
 
 extern void fgProcessWork   ( SFG_Window *window );
 extern fg_time_t fgPlatformSystemTime ( void );
-extern void fgPlatformSleepForEvents( fg_time_t msec );
+extern void fgPlatformSleepForEvents( fg_time_t usec );
+extern void fgPlatformWakeMainLoop( void );
+extern GLboolean fgPlatformAddInputFd( int fd, int events, GLboolean isNew );
+extern void fgPlatformRemoveInputFd( int fd );
+extern void fgPlatformProcessInputFds( void );
+extern int fgPlatformGetEventFds( int *fds, int *events, int maxFds );
+extern GLboolean fgPlatformHasPendingEvents( void );
+extern void fgPlatformDrainEventFds( void );
 extern void fgPlatformProcessSingleEvent ( void );
 extern void fgPlatformMainLoopPreliminaryWork ( void );
 
@@ -55,6 +62,38 @@ extern void fgPlatformInitWork(SFG_Window* window);
 extern void fgPlatformPosResZordWork(SFG_Window* window, unsigned int workMask);
 extern void fgPlatformVisibilityWork(SFG_Window* window);
 
+/*
+ * A call queued from another thread by glutRunOnMainLoop() or
+ * glutPostWindowRedisplayAsync(), to be made by the main loop.
+ */
+typedef struct tagSFG_AsyncCall SFG_AsyncCall;
+struct tagSFG_AsyncCall
+{
+    SFG_AsyncCall  *Next;
+    void          (*Func)( void *data );    /* NULL for a redisplay */
+    void           *Data;
+    int             WindowID;               /* The window to redisplay */
+};
+
+/*
+ * The queued calls, newest first. Any thread pushes onto this lock-free
+ * stack with a compare-and-swap, and the main loop takes it whole; as
+ * nothing else is ever removed, pushing is immune to the ABA problem.
+ */
+static SFG_AsyncCall * volatile fghAsyncCalls = NULL;
+
+#if defined( _MSC_VER )
+#    define FGH_COMPARE_AND_SWAP( ptr, oldValue, newValue ) \
+        ( InterlockedCompareExchangePointer( ( PVOID volatile * )( ptr ), ( newValue ), ( oldValue ) ) == ( oldValue ) )
+#elif defined( __GNUC__ )
+#    define FGH_COMPARE_AND_SWAP( ptr, oldValue, newValue ) \
+        __sync_bool_compare_and_swap( ( ptr ), ( oldValue ), ( newValue ) )
+#else
+     /* No atomic operations known for this compiler, only one thread can be used */
+#    define FGH_COMPARE_AND_SWAP( ptr, oldValue, newValue ) \
+        ( *( ptr ) == ( oldValue ) ? ( *( ptr ) = ( newValue ), 1 ) : 0 )
+#endif
+
 
 /* -- PRIVATE FUNCTIONS ---------------------------------------------------- */
 
@@ -85,7 +124,7 @@ void fghOnReshapeNotify(SFG_Window *window, int width, int height, GLboolean for
          * window.
          * DN: Hmm.. the above sounds like a concern only in single buffered mode...
          */
-        window->State.WorkMask |= GLUT_DISPLAY_WORK;
+        fgAddToWindowWorkList( window, GLUT_DISPLAY_WORK );
         if( window->IsMenu )
             fgSetWindow( saved_window );
     }
@@ -135,6 +174,51 @@ void fghRedrawWindow ( SFG_Window *window )
     fgSetWindow( current_window );
 }
 
+/*
+ * Queues a window for fghRedrawWindows(), after the windows that share its
+ * OpenGL context, so that consecutive redraws need no context switch.
+ */
+static void fghQueueRedraw( SFG_Window *window )
+{
+    SFG_WindowList *entry;
+
+    if( window->RedrawEntry.window )
+        return;
+    window->RedrawEntry.window = window;
+
+    for( entry = fgStructure.RedrawList.Last; entry; entry = entry->node.Prev )
+        if( entry->window->Window.Context == window->Window.Context )
+        {
+            fgListInsert( &fgStructure.RedrawList, entry->node.Next, &window->RedrawEntry.node );
+            return;
+        }
+
+    fgListAppend( &fgStructure.RedrawList, &window->RedrawEntry.node );
+}
+
+/*
+ * Redraws the windows queued by fghQueueRedraw(), leaving the last one
+ * current; fghProcessWork() restores the current window afterwards.
+ */
+static void fghRedrawWindows( void )
+{
+    SFG_WindowList *entry;
+
+    while( ( entry = fgStructure.RedrawList.First ) )
+    {
+        SFG_Window *window = entry->window;
+
+        fgListRemove( &fgStructure.RedrawList, &entry->node );
+        window->RedrawEntry.window = NULL;
+
+        if( window->State.Visible )
+        {
+            fgSetWindow( window );
+            INVOKE_WCB( *window, Display, ( ) );
+        }
+    }
+}
+
 void fghRedrawWindowAndChildren ( SFG_Window *window )
 {
     SFG_Window* child;
@@ -150,69 +234,380 @@ void fghRedrawWindowAndChildren ( SFG_Window *window )
 }
 
 
-static void fghcbProcessWork( SFG_Window *window,
-                              SFG_Enumerator *enumerator )
+/*
+ * Make all windows on the work list process their work. Windows that get
+ * (re)queued by the callbacks are left for the next pass.
+ *
+ * The display callbacks leave their window current, and the window that
+ * was current before is only set back once all the work is done, so that
+ * redrawing N windows doesn't take 2N context switches.
+ */
+static void fghProcessWork( void )
 {
-    if( window->State.WorkMask )
-        fgProcessWork ( window );
+    SFG_WindowList *entry;
+    int current_id = fgStructure.CurrentWindow ? fgStructure.CurrentWindow->ID : 0;
+    unsigned int pass = ++fgStructure.WorkPass;
+
+    if( !fgStructure.WorkList.First )
+        return;
+
+    while( ( entry = fgStructure.WorkList.First ) &&
+           entry->window->WorkPass != pass )
+    {
+        SFG_Window *window = entry->window;
 
-    fgEnumSubWindows( window, fghcbProcessWork, enumerator );
+        fgRemoveFromWindowWorkList( window );
+        if( window->State.WorkMask )
+            fgProcessWork ( window );
+    }
+
+    fghRedrawWindows( );
+
+    /* The window that was current may have been destroyed by a callback */
+    if( current_id &&
+        ( !fgStructure.CurrentWindow || fgStructure.CurrentWindow->ID != current_id ) )
+    {
+        SFG_Window *current_window = fgWindowByID( current_id );
+        if( current_window )
+            fgSetWindow( current_window );
+    }
 }
 
 /*
- * Make all windows process their work list
+ * The pending timers are kept in a binary min-heap (fgState.Timers) on
+ * trigger time, so the next timer to fire is always fgState.Timers[0].
+ * Timers with equal trigger times fire in the order they were registered,
+ * which the heap itself does not guarantee, hence the Sequence number
+ * used as tie-breaker. Pending timers are also linked into a bucket of
+ * fgState.TimerIDs, so glutCancelTimer doesn't have to search the heap.
  */
-static void fghProcessWork( void )
+static GLboolean fghTimerBefore( const SFG_Timer *a, const SFG_Timer *b )
+{
+    return a->TriggerTime < b->TriggerTime ||
+           ( a->TriggerTime == b->TriggerTime && a->Sequence < b->Sequence );
+}
+
+static void fghSetTimerHeapEntry( int index, SFG_Timer *timer )
+{
+    fgState.Timers[ index ] = timer;
+    timer->HeapIndex = index;
+}
+
+static void fghTimerHeapUp( int index )
+{
+    SFG_Timer *timer = fgState.Timers[ index ];
+
+    while( index > 0 )
+    {
+        int parent = ( index - 1 ) / 2;
+        if( !fghTimerBefore( timer, fgState.Timers[ parent ] ) )
+            break;
+        fghSetTimerHeapEntry( index, fgState.Timers[ parent ] );
+        index = parent;
+    }
+    fghSetTimerHeapEntry( index, timer );
+}
+
+static void fghTimerHeapDown( int index )
+{
+    SFG_Timer *timer = fgState.Timers[ index ];
+
+    for( ;; )
+    {
+        int child = 2 * index + 1;
+        if( child >= fgState.NumTimers )
+            break;
+        if( child + 1 < fgState.NumTimers &&
+            fghTimerBefore( fgState.Timers[ child + 1 ], fgState.Timers[ child ] ) )
+            child++;
+        if( !fghTimerBefore( fgState.Timers[ child ], timer ) )
+            break;
+        fghSetTimerHeapEntry( index, fgState.Timers[ child ] );
+        index = child;
+    }
+    fghSetTimerHeapEntry( index, timer );
+}
+
+/* Get a timer hook, reusing a free one if possible */
+SFG_Timer *fgNewTimer( void )
+{
+    SFG_Timer *timer;
+
+    if( (timer = fgState.FreeTimers.Last) )
+    {
+        fgListRemove( &fgState.FreeTimers, &timer->Node );
+    }
+    else
+    {
+        if( ! (timer = malloc(sizeof(SFG_Timer))) )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in glutTimerFunc()" );
+    }
+
+    timer->Internal = GL_FALSE;
+    return timer;
+}
+
+/* Queue a timer whose ID, callback and trigger time have been set */
+void fgAddTimer( SFG_Timer *timer )
+{
+    if( fgState.NumTimers == fgState.TimersSize )
+    {
+        int newSize = fgState.TimersSize ? 2 * fgState.TimersSize : 16;
+        SFG_Timer **timers = realloc( fgState.Timers, newSize * sizeof(SFG_Timer *) );
+        if( !timers )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in glutTimerFunc()" );
+        fgState.Timers     = timers;
+        fgState.TimersSize = newSize;
+    }
+
+    timer->Sequence = fgState.TimerSequence++;
+    fghSetTimerHeapEntry( fgState.NumTimers++, timer );
+    fghTimerHeapUp( timer->HeapIndex );
+
+    fgListAppend( &fgState.TimerIDs[ (unsigned int)timer->ID % FREEGLUT_TIMER_ID_BUCKETS ], &timer->Node );
+}
+
+/* Take a pending timer out of the queue and put it on the free list */
+void fgRemoveTimer( SFG_Timer *timer )
+{
+    int index = timer->HeapIndex;
+    SFG_Timer *last = fgState.Timers[ --fgState.NumTimers ];
+
+    if( index != fgState.NumTimers )
+    {
+        /* Fill the hole with the last entry, which may have to move either way */
+        fghSetTimerHeapEntry( index, last );
+        fghTimerHeapUp( index );
+        fghTimerHeapDown( last->HeapIndex );
+    }
+
+    fgListRemove( &fgState.TimerIDs[ (unsigned int)timer->ID % FREEGLUT_TIMER_ID_BUCKETS ], &timer->Node );
+    fgListAppend( &fgState.FreeTimers, &timer->Node );
+}
+
+/* Free all timers, pending or not */
+void fgDestroyTimers( void )
 {
-    SFG_Enumerator enumerator;
+    SFG_Timer *timer;
+    int i;
 
-    enumerator.found = GL_FALSE;
-    enumerator.data  =  NULL;
+    for( i = 0; i < fgState.NumTimers; i++ )
+        free( fgState.Timers[ i ] );
+    free( fgState.Timers );
+    fgState.Timers        = NULL;
+    fgState.NumTimers     = 0;
+    fgState.TimersSize    = 0;
+    fgState.TimerSequence = 0;
 
-    fgEnumWindows( fghcbProcessWork, &enumerator );
+    for( i = 0; i < FREEGLUT_TIMER_ID_BUCKETS; i++ )
+        fgListInit( &fgState.TimerIDs[ i ] );
+
+    while( ( timer = fgState.FreeTimers.First) )
+    {
+        fgListRemove( &fgState.FreeTimers, &timer->Node );
+        free( timer );
+    }
 }
 
 /*
- * Window enumerator callback to check for the joystick polling code
+ * Queues a call for the main loop and wakes it up. This is the only part
+ * of freeglut that may run on other threads, so it touches nothing but
+ * fghAsyncCalls and the platform's wake up mechanism.
  */
-static void fghcbCheckJoystickPolls( SFG_Window *window,
-                                     SFG_Enumerator *enumerator )
+static void fghPushAsyncCall( void ( *func )( void *data ), void *data, int windowID )
 {
-    fg_time_t checkTime;
+    SFG_AsyncCall *call = malloc( sizeof( SFG_AsyncCall ) );
 
-    if (window->State.JoystickPollRate > 0 && FETCH_WCB( *window, Joystick ))
+    if( !call )
+        return;
+    call->Func     = func;
+    call->Data     = data;
+    call->WindowID = windowID;
+
+    do
+        call->Next = fghAsyncCalls;
+    while( !FGH_COMPARE_AND_SWAP( &fghAsyncCalls, call->Next, call ) );
+
+    fgPlatformWakeMainLoop( );
+}
+
+/*
+ * Takes all the queued calls, oldest first.
+ */
+static SFG_AsyncCall *fghTakeAsyncCalls( void )
+{
+    SFG_AsyncCall *calls, *next, *reversed = NULL;
+
+    do
+        calls = fghAsyncCalls;
+    while( calls && !FGH_COMPARE_AND_SWAP( &fghAsyncCalls, calls, NULL ) );
+
+    for( ; calls; calls = next )
     {
-        /* This window has a joystick to be polled (if pollrate <= 0, user needs to poll manually with glutForceJoystickFunc */
-        checkTime= fgElapsedTime( );
+        next = calls->Next;
+        calls->Next = reversed;
+        reversed = calls;
+    }
+    return reversed;
+}
 
-        if( window->State.JoystickLastPoll + window->State.JoystickPollRate <=
-            checkTime )
-        {
-#if !defined(_WIN32_WCE)
-            fgJoystickPollWindow( window );
-#endif /* !defined(_WIN32_WCE) */
-            window->State.JoystickLastPoll = checkTime;
-        }
+/*
+ * Makes the calls queued by other threads. Those queued while this runs
+ * are left for the next main loop iteration.
+ */
+static void fghRunAsyncCalls( void )
+{
+    SFG_AsyncCall *call, *next;
+
+    /* The common case, without any atomic operation */
+    if( !fghAsyncCalls )
+        return;
+
+    for( call = fghTakeAsyncCalls( ); call; call = next )
+    {
+        next = call->Next;
+        if( call->Func )
+            call->Func( call->Data );
+        else
+            glutPostWindowRedisplay( call->WindowID );
+        free( call );
     }
+}
 
-    fgEnumSubWindows( window, fghcbCheckJoystickPolls, enumerator );
+/*
+ * Drops the calls not made yet, when freeglut shuts down.
+ */
+void fgDestroyAsyncCalls( void )
+{
+    SFG_AsyncCall *call, *next;
+
+    for( call = fghTakeAsyncCalls( ); call; call = next )
+    {
+        next = call->Next;
+        free( call );
+    }
 }
 
 /*
- * Check all windows for joystick polling
- *
- * The real way to do this is to make use of the glutTimer() API
- * to more cleanly re-implement the joystick API.  Then, this code
- * and all other "joystick timer" code can be yanked.
+ * Finds the glutAddInputFd() registration for a descriptor, if any.
+ * Descriptors are small integers, so they index fgState.InputFdSlots.
  */
-static void fghCheckJoystickPolls( void )
+static SFG_InputFd *fghFindInputFd( int fd )
 {
-    SFG_Enumerator enumerator;
+    int slot;
 
-    enumerator.found = GL_FALSE;
-    enumerator.data  =  NULL;
+    if( fd < 0 || fd >= fgState.InputFdSlotsSize )
+        return NULL;
 
-    fgEnumWindows( fghcbCheckJoystickPolls, &enumerator );
+    slot = fgState.InputFdSlots[ fd ];
+    return slot < 0 ? NULL : &fgState.InputFds[ slot ];
+}
+
+/*
+ * Starts, or changes, waiting on an application's descriptor. Returns
+ * GL_FALSE if the platform can't wait on it.
+ */
+GLboolean fgAddInputFd( int fd, int events, FGCBInputFdUC callback, FGCBUserData userData )
+{
+    SFG_InputFd *inputFd = fghFindInputFd( fd );
+
+    if( !inputFd && fgState.NumInputFds == fgState.InputFdsSize )
+    {
+        int newSize = fgState.InputFdsSize ? fgState.InputFdsSize * 2 : 16;
+        SFG_InputFd *inputFds = realloc( fgState.InputFds, newSize * sizeof(SFG_InputFd) );
+        if( !inputFds )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in glutAddInputFd()" );
+        fgState.InputFds = inputFds;
+        fgState.InputFdsSize = newSize;
+    }
+
+    if( fd >= fgState.InputFdSlotsSize )
+    {
+        int i, newSize = fgState.InputFdSlotsSize ? fgState.InputFdSlotsSize : 64;
+        int *slots;
+
+        while( newSize <= fd )
+            newSize *= 2;
+        slots = realloc( fgState.InputFdSlots, newSize * sizeof(int) );
+        if( !slots )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in glutAddInputFd()" );
+        for( i = fgState.InputFdSlotsSize; i < newSize; i++ )
+            slots[ i ] = -1;
+        fgState.InputFdSlots = slots;
+        fgState.InputFdSlotsSize = newSize;
+    }
+
+    if( !fgPlatformAddInputFd( fd, events, !inputFd ) )
+        return GL_FALSE;
+
+    if( !inputFd )
+    {
+        fgState.InputFdSlots[ fd ] = fgState.NumInputFds;
+        inputFd = &fgState.InputFds[ fgState.NumInputFds++ ];
+        inputFd->Fd = fd;
+    }
+    inputFd->Events       = events;
+    inputFd->Callback     = callback;
+    inputFd->CallbackData = userData;
+    return GL_TRUE;
+}
+
+/*
+ * Stops waiting on an application's descriptor
+ */
+void fgRemoveInputFd( int fd )
+{
+    SFG_InputFd *inputFd = fghFindInputFd( fd );
+
+    if( !inputFd )
+        return;
+
+    fgPlatformRemoveInputFd( fd );
+
+    /* The last registration moves into the freed slot */
+    *inputFd = fgState.InputFds[ --fgState.NumInputFds ];
+    fgState.InputFdSlots[ inputFd->Fd ] = fgState.InputFdSlots[ fd ];
+    fgState.InputFdSlots[ fd ] = -1;
+}
+
+/*
+ * Calls back for a descriptor the platform found ready. It is looked up
+ * again each time, as an earlier callback may have removed or changed it.
+ */
+void fgDispatchInputFd( int fd, int events )
+{
+    SFG_InputFd *inputFd = fghFindInputFd( fd );
+    FGCBInputFdUC callback;
+    FGCBUserData userData;
+
+    if( !inputFd )
+        return;
+
+    events &= inputFd->Events | GLUT_INPUT_ERROR;
+    if( !events )
+        return;
+
+    callback = inputFd->Callback;
+    userData = inputFd->CallbackData;
+    callback( fd, events, userData );
+}
+
+/*
+ * Forgets the application's descriptors, when freeglut shuts down
+ */
+void fgDestroyInputFds( void )
+{
+    free( fgState.InputFds );
+    fgState.InputFds = NULL;
+    fgState.NumInputFds = 0;
+    fgState.InputFdsSize = 0;
+    free( fgState.InputFdSlots );
+    fgState.InputFdSlots = NULL;
+    fgState.InputFdSlotsSize = 0;
 }
 
 /*
@@ -222,27 +617,26 @@ static void fghCheckTimers( void )
 {
     fg_time_t checkTime = fgElapsedTime( );
 
-    while( fgState.Timers.First )
+    while( fgState.NumTimers )
     {
-        SFG_Timer *timer = fgState.Timers.First;
+        SFG_Timer *timer = fgState.Timers[ 0 ];
 
         if( timer->TriggerTime > checkTime )
-            /* Timers are sorted by triggerTime */
+            /* The heap's top is the first timer to fire */
             break;
 
-        fgListRemove( &fgState.Timers, &timer->Node );
-        fgListAppend( &fgState.FreeTimers, &timer->Node );
+        fgRemoveTimer( timer );
 
         timer->Callback( timer->ID, timer->CallbackData );
     }
 }
 
 
-/* Platform-dependent time in milliseconds, as an unsigned 64-bit integer.
+/* Platform-dependent time in microseconds, as an unsigned 64-bit integer.
  * This doesn't overflow in any reasonable time, so no need to worry about
- * that. The GLUT API return value will however overflow after 49.7 days,
- * which means you will still get in trouble when running the
- * application for more than 49.7 days.
+ * that. The GLUT API return value will however overflow after 49.7 days
+ * (GLUT_ELAPSED_TIME) or 71.6 minutes (GLUT_ELAPSED_TIME_US), which means
+ * you will still get in trouble when not working with differences.
  */
 fg_time_t fgSystemTime(void)
 {
@@ -325,40 +719,33 @@ void fgWarning( const char *fmt, ... )
 /*
  * Indicates whether work is pending for ANY window.
  *
- * The current mechanism is to walk all of the windows and ask if
- * work is pending. We have a short-circuit early return if we find any.
+ * Only the windows on the work list can have work, though some of them
+ * may have had their work bits cleared since they were queued.
  */
-static void fghHavePendingWorkCallback( SFG_Window* w, SFG_Enumerator* e)
-{
-    if( w->State.WorkMask )
-    {
-        e->found = GL_TRUE;
-        e->data = w;
-        return;
-    }
-    fgEnumSubWindows( w, fghHavePendingWorkCallback, e );
-}
 static int fghHavePendingWork (void)
 {
-    SFG_Enumerator enumerator;
+    SFG_WindowList *entry;
 
-    enumerator.found = GL_FALSE;
-    enumerator.data = NULL;
-    fgEnumWindows( fghHavePendingWorkCallback, &enumerator );
-    return !!enumerator.data;
+    for( entry = fgStructure.WorkList.First; entry; entry = entry->node.Next )
+        if( entry->window->State.WorkMask )
+            return 1;
+
+    return 0;
 }
 
 /*
- * Returns the number of GLUT ticks (milliseconds) till the next timer event.
+ * Returns the number of microseconds till the next timer event.
  */
 static fg_time_t fghNextTimer( void )
 {
     fg_time_t currentTime;
-    SFG_Timer *timer = fgState.Timers.First;    /* timers are sorted by trigger time, so only have to check the first */
+    SFG_Timer *timer;
 
-    if( !timer )
+    if( !fgState.NumTimers )
         return INT_MAX;
 
+    timer = fgState.Timers[ 0 ];    /* the heap's top is the first timer to fire */
+
     currentTime = fgElapsedTime();
     if( timer->TriggerTime < currentTime )
         return 0;
@@ -368,18 +755,14 @@ static fg_time_t fghNextTimer( void )
 
 static void fghSleepForEvents( void )
 {
-    fg_time_t msec;
+    fg_time_t usec;
 
     if( fghHavePendingWork( ) )
         return;
 
-    msec = fghNextTimer( );
-    /* XXX Should use GLUT timers for joysticks... */
-    /* XXX Dumb; forces granularity to .01sec */
-    if( fgState.NumActiveJoysticks>0 && ( msec > 10 ) )
-        msec = 10;
-
-    fgPlatformSleepForEvents ( msec );
+    /* Joystick polls are timers too, see fg_joystick.c */
+    usec = fghNextTimer( );
+    fgPlatformSleepForEvents ( usec );
 }
 
 
@@ -432,7 +815,13 @@ void fgProcessWork(SFG_Window *window)
             /* NB: do this before the display callback is called as user might call postredisplay in his display callback */
             window->State.WorkMask &= ~GLUT_DISPLAY_WORK;
 
-            fghRedrawWindow ( window );
+            if( fgState.BatchedRedraw )
+                fghQueueRedraw( window );
+            else
+            {
+                fgSetWindow( window );
+                INVOKE_WCB( *window, Display, ( ) );
+            }
         }
     }
 }
@@ -448,10 +837,15 @@ void FGAPIENTRY glutMainLoopEvent( void )
     /* Process input */
     fgPlatformProcessSingleEvent ();
 
-    if( fgState.Timers.First )
+    /* Calls from other threads, before the work they may have queued */
+    fghRunAsyncCalls( );
+
+    /* The application's descriptors, see glutAddInputFd() */
+    if( fgState.NumInputFds )
+        fgPlatformProcessInputFds( );
+
+    if( fgState.NumTimers )
         fghCheckTimers( );
-    if (fgState.NumActiveJoysticks>0)   /* If zero, don't poll joysticks */
-        fghCheckJoystickPolls( );
 
     /* Perform work on the window (position, reshape, display, etc) */
     fghProcessWork( );
@@ -466,6 +860,43 @@ void FGAPIENTRY glutMainLoopEvent( void )
     fgCloseWindows( );
 }
 
+/*
+ * Called after glutMainLoopEvent(): returns a window that is not a menu,
+ * or NULL if the main loop is to end, as it was left or there is none.
+ */
+static SFG_Window *fghMainLoopWindow( void )
+{
+    SFG_Window *window;
+
+    if( fgState.ExecState != GLUT_EXEC_STATE_RUNNING )
+        return NULL;
+    /*
+     * Step through the list of windows, seeing if there are any
+     * that are not menus
+     */
+    for( window = ( SFG_Window * )fgStructure.Windows.First;
+         window;
+         window = ( SFG_Window * )window->Node.Next )
+        if ( ! ( window->IsMenu ) )
+            break;
+
+    if( ! window )
+        fgState.ExecState = GLUT_EXEC_STATE_STOP;
+    return window;
+}
+
+/*
+ * Calls the idle callback, with window current rather than a menu
+ */
+static void fghCallIdle( SFG_Window *window )
+{
+    if( fgStructure.CurrentWindow &&
+        fgStructure.CurrentWindow->IsMenu )
+        /* fail safe */
+        fgSetWindow( window );
+    fgState.IdleCallback( fgState.IdleCallbackData );
+}
+
 /*
  * Enters the freeglut processing loop.
  * Stays until the "ExecState" changes to "GLUT_EXEC_STATE_STOP".
@@ -487,33 +918,14 @@ void FGAPIENTRY glutMainLoop( void )
         SFG_Window *window;
 
         glutMainLoopEvent( );
-        if( fgState.ExecState != GLUT_EXEC_STATE_RUNNING )
+        window = fghMainLoopWindow( );
+        if( ! window )
             break;
-        /*
-         * Step through the list of windows, seeing if there are any
-         * that are not menus
-         */
-        for( window = ( SFG_Window * )fgStructure.Windows.First;
-             window;
-             window = ( SFG_Window * )window->Node.Next )
-            if ( ! ( window->IsMenu ) )
-                break;
 
-        if( ! window )
-            fgState.ExecState = GLUT_EXEC_STATE_STOP;
+        if( fgState.IdleCallback )
+            fghCallIdle( window );
         else
-        {
-            if( fgState.IdleCallback )
-            {
-                if( fgStructure.CurrentWindow &&
-                    fgStructure.CurrentWindow->IsMenu )
-                    /* fail safe */
-                    fgSetWindow( window );
-                fgState.IdleCallback( fgState.IdleCallbackData );
-            }
-            else
-                fghSleepForEvents( );
-        }
+            fghSleepForEvents( );
     }
 
     /*
@@ -537,6 +949,116 @@ void FGAPIENTRY glutLeaveMainLoop( void )
     fgState.ExecState = GLUT_EXEC_STATE_STOP ;
 }
 
+/*
+ * The functions below let applications that have their own event loop
+ * run freeglut's from it: wait on the glutGetEventFds() descriptors for
+ * at most glutGetNextTimeout() milliseconds, then call glutDispatchReady().
+ */
+
+/*
+ * Stores in fds the descriptors to wait on, and in events (if not NULL)
+ * the GLUT_INPUT_* events to wait for on each. Returns how many there are,
+ * which may be more than maxFds. They change with joysticks and the
+ * glutAddInputFd() descriptors, so ask again before each wait.
+ */
+int FGAPIENTRY glutGetEventFds( int *fds, int *events, int maxFds )
+{
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutGetEventFds" );
+    return fgPlatformGetEventFds( fds, events, maxFds );
+}
+
+/*
+ * Returns the number of milliseconds to wait for at most, rounded up so
+ * that timers are due on waking up: 0 if there is something to do already,
+ * -1 if there is no timer and waiting for the descriptors is enough.
+ */
+int FGAPIENTRY glutGetNextTimeout( void )
+{
+    fg_time_t usec;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutGetNextTimeout" );
+
+    /* Events already read from the display don't make its descriptor ready */
+    if( fgPlatformHasPendingEvents( ) || fghAsyncCalls ||
+        fgState.IdleCallback || fghHavePendingWork( ) )
+        return 0;
+
+    /* Joystick polls are timers too, see fg_joystick.c */
+    if( !fgState.NumTimers )
+        return -1;
+
+    usec = fghNextTimer( );
+    return (int)MIN( ( usec + 999 ) / 1000, INT_MAX );
+}
+
+/*
+ * Runs one iteration of glutMainLoop() without waiting. Returns 0 once the
+ * main loop would have ended, after which the application is to call
+ * glutExit().
+ */
+int FGAPIENTRY glutDispatchReady( void )
+{
+    SFG_Window *window;
+
+    FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutDispatchReady" );
+
+    /* The first call starts the main loop */
+    if( fgState.ExecState == GLUT_EXEC_STATE_INIT )
+    {
+        fgPlatformMainLoopPreliminaryWork ();
+        fgState.ExecState = GLUT_EXEC_STATE_RUNNING ;
+    }
+
+    /*
+     * Whether or not the application's wait ended on them, the wake up and
+     * joystick descriptors must not stay ready. Before glutMainLoopEvent(),
+     * so that no wake up for a later call is lost.
+     */
+    fgPlatformDrainEventFds( );
+
+    glutMainLoopEvent( );
+    window = fghMainLoopWindow( );
+    if( ! window )
+        return 0;
+
+    if( fgState.IdleCallback )
+        fghCallIdle( window );
+    return 1;
+}
+
+/*
+ * The functions below may be called from any thread, between glutInit()
+ * and the main loop's end. They only queue work for the main loop thread
+ * and wake it up, every other freeglut function must still be called from
+ * that thread.
+ */
+
+/*
+ * Wakes the main loop up if it is waiting for events, so that it runs
+ * another iteration.
+ */
+void FGAPIENTRY glutWakeMainLoop( void )
+{
+    fgPlatformWakeMainLoop( );
+}
+
+/*
+ * Has the main loop call func( data ), in the order the calls were made.
+ */
+void FGAPIENTRY glutRunOnMainLoop( void ( *func )( void *data ), void *data )
+{
+    if( func )
+        fghPushAsyncCall( func, data, 0 );
+}
+
+/*
+ * glutPostWindowRedisplay(), from any thread.
+ */
+void FGAPIENTRY glutPostWindowRedisplayAsync( int windowID )
+{
+    fghPushAsyncCall( NULL, NULL, windowID );
+}
+
 
 
 /*** END OF FILE ***/
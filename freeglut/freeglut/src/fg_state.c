@@ -126,6 +126,37 @@ void FGAPIENTRY glutSetOption( GLenum eWhat, int value )
       fgState.AllowNegativeWindowPosition = !!value;
       break;
 
+    case GLUT_SHAPE_CACHE_MEMORY:
+      fgState.ShapeCacheMemory = value > 0 ? value : 0;
+      fgTrimShapeCache( fgState.ShapeCacheMemory );
+      break;
+
+    case GLUT_BITMAP_FONT_ATLAS:
+      fgState.BitmapFontAtlas = !!value;
+      break;
+
+    case GLUT_BATCHED_REDRAW:
+      fgState.BatchedRedraw = !!value;
+      break;
+
+    case GLUT_COALESCE_EVENTS:
+      fgState.CoalesceEvents = !!value;
+      break;
+
+    case GLUT_TEASET_SOLID_SUBDIVISIONS:
+      fgState.TeasetSolidSubdivs = value < 2 ? 2 :
+                                   value > FREEGLUT_MAX_TEASET_SUBDIV ? FREEGLUT_MAX_TEASET_SUBDIV : value;
+      break;
+
+    case GLUT_TEASET_WIRE_SUBDIVISIONS:
+      fgState.TeasetWireSubdivs = value < 2 ? 2 :
+                                  value > FREEGLUT_MAX_TEASET_SUBDIV ? FREEGLUT_MAX_TEASET_SUBDIV : value;
+      break;
+
+    case GLUT_AUTHORITATIVE_GEOMETRY:
+      fgState.AuthoritativeGeometry = !!value;
+      break;
+
     default:
         fgWarning( "glutSetOption(): missing enum handle %d", eWhat );
         break;
@@ -149,6 +180,12 @@ int FGAPIENTRY glutGet( GLenum eWhat )
      * XXX: a glutGet64 to return the time might be an idea...
      */
     case GLUT_ELAPSED_TIME:
+        return (int) ( fgElapsedTime() / 1000 );
+
+    /* Same, but in microseconds, wrapping every 71.6 minutes. Meant for
+     * frame pacing: cast to unsigned int before taking differences.
+     */
+    case GLUT_ELAPSED_TIME_US:
         return (int) fgElapsedTime();
     }
 
@@ -232,6 +269,33 @@ int FGAPIENTRY glutGet( GLenum eWhat )
     case GLUT_ALLOW_NEGATIVE_WINDOW_POSITION:
         return fgState.AllowNegativeWindowPosition;
 
+    case GLUT_SHAPE_CACHE_MEMORY:
+        return fgState.ShapeCacheMemory;
+
+    case GLUT_SHAPE_CACHE_HITS:
+        return fgState.ShapeCacheHits;
+
+    case GLUT_SHAPE_CACHE_MISSES:
+        return fgState.ShapeCacheMisses;
+
+    case GLUT_BITMAP_FONT_ATLAS:
+        return fgState.BitmapFontAtlas;
+
+    case GLUT_BATCHED_REDRAW:
+        return fgState.BatchedRedraw;
+
+    case GLUT_COALESCE_EVENTS:
+        return fgState.CoalesceEvents;
+
+    case GLUT_TEASET_SOLID_SUBDIVISIONS:
+        return fgState.TeasetSolidSubdivs;
+
+    case GLUT_TEASET_WIRE_SUBDIVISIONS:
+        return fgState.TeasetWireSubdivs;
+
+    case GLUT_AUTHORITATIVE_GEOMETRY:
+        return fgState.AuthoritativeGeometry;
+
     default:
         return fgPlatformGlutGet ( eWhat );
         break;
@@ -38,6 +38,9 @@
 SFG_Structure fgStructure = { { NULL, NULL },  /* The list of windows       */
                               { NULL, NULL },  /* The list of menus         */
                               { NULL, NULL },  /* Windows to Destroy list   */
+                              { NULL, NULL },  /* Windows with pending work */
+                              0,               /* The work pass counter     */
+                              { NULL, NULL },  /* Windows to redraw         */
                               NULL,            /* The current window        */
                               NULL,            /* The current menu          */
                               NULL,            /* The menu OpenGL context   */
@@ -46,8 +49,150 @@ SFG_Structure fgStructure = { { NULL, NULL },  /* The list of windows       */
                               0 };             /* The current new menu ID   */
 
 
+/*
+ * Open addressing hash tables indexing the windows and menus, so that
+ * looking one up doesn't have to enumerate them all. The handle table is
+ * only a cache, checked on every hit, as the platform code sets window
+ * handles behind our back.
+ */
+typedef struct tagSFG_ObjectMap SFG_ObjectMap;
+struct tagSFG_ObjectMap
+{
+    unsigned long  *Keys;
+    void          **Values;     /* NULL if free, fghMapTombstone if removed */
+    int             Size;       /* Number of slots, a power of two          */
+    int             Used;       /* Slots that are not free                  */
+};
+
+static SFG_ObjectMap windowsByID     = { NULL, NULL, 0, 0 };
+static SFG_ObjectMap windowsByHandle = { NULL, NULL, 0, 0 };
+static SFG_ObjectMap menusByID       = { NULL, NULL, 0, 0 };
+static char fghMapTombstone;
+
+
 /* -- PRIVATE FUNCTIONS ---------------------------------------------------- */
 
+static unsigned int fghMapSlot( const SFG_ObjectMap *map, unsigned long key )
+{
+    key ^= key >> 16;
+    key *= 0x45d9f3bUL;
+    key ^= key >> 16;
+    return (unsigned int)key & ( map->Size - 1 );
+}
+
+static void *fghMapGet( const SFG_ObjectMap *map, unsigned long key )
+{
+    unsigned int i;
+
+    if( !map->Size )
+        return NULL;
+
+    for( i = fghMapSlot( map, key ); map->Values[ i ]; i = ( i + 1 ) & ( map->Size - 1 ) )
+        if( map->Keys[ i ] == key && map->Values[ i ] != &fghMapTombstone )
+            return map->Values[ i ];
+
+    return NULL;
+}
+
+static void fghMapRemove( SFG_ObjectMap *map, unsigned long key )
+{
+    unsigned int i;
+
+    if( !map->Size )
+        return;
+
+    for( i = fghMapSlot( map, key ); map->Values[ i ]; i = ( i + 1 ) & ( map->Size - 1 ) )
+        if( map->Keys[ i ] == key && map->Values[ i ] != &fghMapTombstone )
+        {
+            map->Values[ i ] = &fghMapTombstone;
+            return;
+        }
+}
+
+/* Removes all the entries of a value, whatever their keys */
+static void fghMapRemoveValue( SFG_ObjectMap *map, void *value )
+{
+    int i;
+
+    for( i = 0; i < map->Size; i++ )
+        if( map->Values[ i ] == value )
+            map->Values[ i ] = &fghMapTombstone;
+}
+
+static void fghMapPut( SFG_ObjectMap *map, unsigned long key, void *value );
+
+/* Rehashes into a table large enough for the live entries, dropping tombstones */
+static void fghMapGrow( SFG_ObjectMap *map )
+{
+    SFG_ObjectMap old = *map;
+    int i, count = 0;
+
+    for( i = 0; i < old.Size; i++ )
+        if( old.Values[ i ] && old.Values[ i ] != &fghMapTombstone )
+            count++;
+
+    map->Size = 16;
+    while( map->Size < 2 * ( count + 1 ) )
+        map->Size *= 2;
+    map->Used   = 0;
+    map->Keys   = malloc( map->Size * sizeof( unsigned long ) );
+    map->Values = calloc( map->Size, sizeof( void * ) );
+    if( !map->Keys || !map->Values )
+        fgError( "Out of memory. Could not index windows and menus." );
+
+    for( i = 0; i < old.Size; i++ )
+        if( old.Values[ i ] && old.Values[ i ] != &fghMapTombstone )
+            fghMapPut( map, old.Keys[ i ], old.Values[ i ] );
+
+    free( old.Keys );
+    free( old.Values );
+}
+
+/* Adds an entry, or replaces the value of an existing one */
+static void fghMapPut( SFG_ObjectMap *map, unsigned long key, void *value )
+{
+    unsigned int i;
+
+    fghMapRemove( map, key );
+
+    /* Keep at least a quarter of the slots free, so probing stays short */
+    if( 4 * ( map->Used + 1 ) > 3 * map->Size )
+        fghMapGrow( map );
+
+    for( i = fghMapSlot( map, key );
+         map->Values[ i ] && map->Values[ i ] != &fghMapTombstone;
+         i = ( i + 1 ) & ( map->Size - 1 ) )
+        ;
+
+    if( !map->Values[ i ] )
+        map->Used++;
+    map->Keys[ i ]   = key;
+    map->Values[ i ] = value;
+}
+
+static void fghMapFree( SFG_ObjectMap *map )
+{
+    free( map->Keys );
+    free( map->Values );
+    map->Keys   = NULL;
+    map->Values = NULL;
+    map->Size   = 0;
+    map->Used   = 0;
+}
+
+/* Folds a native window handle, whatever its type, into a table key */
+static unsigned long fghHandleKey( SFG_WindowHandleType handle )
+{
+    const unsigned char *bytes = ( const unsigned char * )&handle;
+    unsigned long key = 2166136261UL;
+    size_t i;
+
+    for( i = 0; i < sizeof( handle ); i++ )
+        key = ( key ^ bytes[ i ] ) * 16777619UL;
+
+    return key;
+}
+
 extern void fgPlatformCreateWindow ( SFG_Window *window );
 extern void fghDefaultReshape(int width, int height, FGCBUserData userData);
 
@@ -90,6 +235,7 @@ SFG_Window* fgCreateWindow( SFG_Window* parent, const char* title,
 
     /* Initialize the object properties */
     window->ID = ++fgStructure.WindowID;
+    fghMapPut( &windowsByID, (unsigned long)window->ID, window );
 
     fgListInit( &window->Children );
     if( parent )
@@ -138,6 +284,7 @@ SFG_Menu* fgCreateMenu( FGCBMenuUC menuCallback, FGCBUserData userData )
 
     /* Initialize the object properties: */
     menu->ID           = ++fgStructure.MenuID;
+    fghMapPut( &menusByID, (unsigned long)menu->ID, menu );
     menu->Callback     = menuCallback;
     menu->CallbackData = userData;
     menu->ActiveEntry  = NULL;
@@ -189,6 +336,34 @@ void fgAddToWindowDestroyList( SFG_Window* window )
     window->State.WorkMask = 0;
 }
 
+/*
+ * Sets work bits on a window and queues it for fgProcessWork(), so that
+ * the main loop only visits the windows that have something to do
+ */
+void fgAddToWindowWorkList( SFG_Window* window, unsigned int workMask )
+{
+    window->State.WorkMask |= workMask;
+
+    if( !window->WorkEntry.window )
+    {
+        window->WorkEntry.window = window;
+        window->WorkPass = fgStructure.WorkPass;
+        fgListAppend( &fgStructure.WorkList, &window->WorkEntry.node );
+    }
+}
+
+/*
+ * Takes a window off the work list. Its work bits are left alone.
+ */
+void fgRemoveFromWindowWorkList( SFG_Window* window )
+{
+    if( window->WorkEntry.window )
+    {
+        fgListRemove( &fgStructure.WorkList, &window->WorkEntry.node );
+        window->WorkEntry.window = NULL;
+    }
+}
+
 /*
  * Function to close down all the windows in the "WindowsToDestroy" list
  */
@@ -219,6 +394,9 @@ void fgDestroyWindow( SFG_Window* window )
     {
         SFG_Window *activeWindow = fgStructure.CurrentWindow;
         INVOKE_WCB( *window, Destroy, ( ) );
+        /* Release cached shape buffers while the context is still alive */
+        fgDestroyGeometryCache( window );
+        fgDestroyFontTextures( window );
         fgSetWindow( activeWindow );
     }
 
@@ -231,6 +409,12 @@ void fgDestroyWindow( SFG_Window* window )
       fgDeactivateMenu( window );
 
     fghClearCallBacks( window );
+    fgJoystickCancelTimer( window );
+    fgRemoveFromWindowWorkList( window );
+    if( window->RedrawEntry.window )
+        fgListRemove( &fgStructure.RedrawList, &window->RedrawEntry.node );
+    fghMapRemove( &windowsByID, (unsigned long)window->ID );
+    fghMapRemoveValue( &windowsByHandle, window );
     fgCloseWindow( window );
     free( window );
     if( fgStructure.CurrentWindow == window )
@@ -337,6 +521,7 @@ void fgDestroyMenu( SFG_Menu* menu )
         fgSetWindow( NULL );
     fgDestroyWindow( menu->Window );
     fgListRemove( &fgStructure.Menus, &menu->Node );
+    fghMapRemove( &menusByID, (unsigned long)menu->ID );
     if( fgStructure.CurrentMenu == menu )
         fgStructure.CurrentMenu = NULL;
 
@@ -360,6 +545,8 @@ void fgCreateStructure( void )
     fgListInit(&fgStructure.Windows);
     fgListInit(&fgStructure.Menus);
     fgListInit(&fgStructure.WindowsToDestroy);
+    fgListInit(&fgStructure.WorkList);
+    fgListInit(&fgStructure.RedrawList);
 
     fgStructure.CurrentWindow = NULL;
     fgStructure.CurrentMenu = NULL;
@@ -385,6 +572,11 @@ void fgDestroyStructure( void )
 
     while( fgStructure.Windows.First )
         fgDestroyWindow( ( SFG_Window * )fgStructure.Windows.First );
+
+    /* The IDs start over with the next glutInit() */
+    fghMapFree( &windowsByID );
+    fghMapFree( &windowsByHandle );
+    fghMapFree( &menusByID );
 }
 
 /*
@@ -485,6 +677,12 @@ static void fghcbWindowByHandle( SFG_Window *window,
 SFG_Window* fgWindowByHandle ( SFG_WindowHandleType hWindow )
 {
     SFG_Enumerator enumerator;
+    unsigned long key = fghHandleKey( hWindow );
+    SFG_Window *window = fghMapGet( &windowsByHandle, key );
+
+    /* Most events are for a window we have seen before */
+    if( window && window->Window.Handle == hWindow )
+        return window;
 
     /* This is easy and makes use of the windows enumeration defined above */
     enumerator.found = GL_FALSE;
@@ -492,86 +690,30 @@ SFG_Window* fgWindowByHandle ( SFG_WindowHandleType hWindow )
     fgEnumWindows( fghcbWindowByHandle, &enumerator );
 
     if( enumerator.found )
-        return( SFG_Window *) enumerator.data;
-    return NULL;
-}
-
-/*
- * A static helper function to look for a window given its ID
- */
-static void fghcbWindowByID( SFG_Window *window, SFG_Enumerator *enumerator )
-{
-    /* Make sure we do not overwrite our precious results... */
-    if( enumerator->found )
-        return;
-
-    /* Check the window's handle. Hope this works. Looks ugly. That's for sure. */
-    if( window->ID == *( int *)(enumerator->data) )
     {
-        enumerator->found = GL_TRUE;
-        enumerator->data = window;
-
-        return;
+        fghMapPut( &windowsByHandle, key, enumerator.data );
+        return( SFG_Window *) enumerator.data;
     }
-
-    /* Otherwise, check this window's children */
-    fgEnumSubWindows( window, fghcbWindowByID, enumerator );
+    return NULL;
 }
 
 /*
  * This function is similar to the previous one, except it is
- * looking for a specified (sub)window identifier. The function
- * is defined in fg_structure.c file.
+ * looking for a specified (sub)window identifier. The IDs are
+ * indexed by fgCreateWindow() and fgDestroyWindow().
  */
 SFG_Window* fgWindowByID( int windowID )
 {
-    SFG_Enumerator enumerator;
-
-    /* Uses a method very similar for fgWindowByHandle... */
-    enumerator.found = GL_FALSE;
-    enumerator.data = ( void * )&windowID;
-    fgEnumWindows( fghcbWindowByID, &enumerator );
-    if( enumerator.found )
-        return ( SFG_Window * )enumerator.data;
-    return NULL;
-}
-
-/*
- * A static helper function to look for a menu given its ID
- */
-static void fghcbMenuByID( SFG_Menu *menu,
-    SFG_Enumerator *enumerator )
-{
-    if ( enumerator->found )
-        return;
-
-    /* Check the menu's ID. */
-    if( menu->ID == *( int *)(enumerator->data) )
-    {
-        enumerator->found = GL_TRUE;
-        enumerator->data = menu;
-
-        return;
-    }
+    return ( SFG_Window * )fghMapGet( &windowsByID, (unsigned long)windowID );
 }
 
 /*
- * Looks up a menu given its ID. This is easier than fgWindowByXXX
- * as all menus are placed in one doubly linked list...
+ * Looks up a menu given its ID, indexed by fgCreateMenu() and
+ * fgDestroyMenu().
  */
 SFG_Menu* fgMenuByID( int menuID )
 {
-    SFG_Enumerator enumerator;
-
-    /* This is easy and makes use of the menus enumeration defined above */
-    enumerator.found = GL_FALSE;
-    enumerator.data = (void *)&menuID;
-    fgEnumMenus( fghcbMenuByID, &enumerator );
-
-    if( enumerator.found )
-        return( SFG_Menu *) enumerator.data;
-
-    return NULL;
+    return ( SFG_Menu * )fghMapGet( &menusByID, (unsigned long)menuID );
 }
 
 /*
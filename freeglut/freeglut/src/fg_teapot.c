@@ -34,108 +34,41 @@
 #include "fg_internal.h"
 #include "fg_teapot_data.h"
 
-/* -- STATIC VARS: CACHES ---------------------------------------------------- */
+/* -- SHAPE DEFINITIONS ----------------------------------------------------- */
 
-/* General defs */
-#define GLUT_SOLID_N_SUBDIV  8
-#define GLUT_WIRE_N_SUBDIV   10
-
-/* Bernstein coefficients only have to be precomputed once (number of patch subdivisions is fixed)
- * Can thus define arrays for them here, they will be filled upon first use.
- * 3rd order Bezier surfaces have 4 Bernstein coeffs.
- * Have separate caches for solid and wire as they use a different number of subdivisions
- * _0 is for Bernstein polynomials, _1 for their first derivative (which we need for normals)
+/*
+ * The teapot, teacup and teaspoon are tessellated at unit scale and kept
+ * in the tessellation cache of fg_geometry.c like the other non-polyhedra,
+ * to be scaled to the requested size when drawn. The Bezier patches of a
+ * shape are thus only evaluated once per subdivision level (see
+ * GLUT_TEASET_SOLID_SUBDIVISIONS and GLUT_TEASET_WIRE_SUBDIVISIONS), no
+ * matter at how many sizes it is drawn.
  */
-static GLfloat bernWire_0 [GLUT_WIRE_N_SUBDIV] [4];
-static GLfloat bernWire_1 [GLUT_WIRE_N_SUBDIV] [4];
-static GLfloat bernSolid_0[GLUT_SOLID_N_SUBDIV][4];
-static GLfloat bernSolid_1[GLUT_SOLID_N_SUBDIV][4];
 
 /* Teapot defs */
-#define GLUT_TEAPOT_N_PATCHES       (6*4 + 4*2)                                                                     /* 6 patches are reproduced (rotated) 4 times, 4 patches (flipped) 2 times */
-#define GLUT_SOLID_TEAPOT_N_VERT    GLUT_SOLID_N_SUBDIV*GLUT_SOLID_N_SUBDIV * GLUT_TEAPOT_N_PATCHES                 /* N_SUBDIV^2 vertices per patch */
-#define GLUT_SOLID_TEAPOT_N_TRI     (GLUT_SOLID_N_SUBDIV-1)*(GLUT_SOLID_N_SUBDIV-1) * GLUT_TEAPOT_N_PATCHES * 2     /* if e.g. 7x7 vertices for each patch, there are 6*6 squares for each patch. Each square is decomposed into 2 triangles */
-
-#define GLUT_WIRE_TEAPOT_N_VERT     GLUT_WIRE_N_SUBDIV*GLUT_WIRE_N_SUBDIV * GLUT_TEAPOT_N_PATCHES                   /* N_SUBDIV^2 vertices per patch */
-
-/* Bit of caching:
- * vertex indices and normals only need to be generated once for
- * a given number of subdivisions as they don't change with scale.
- * Vertices can be cached and reused if scale didn't change.
- */
-static GLushort vertIdxsTeapotS[GLUT_SOLID_TEAPOT_N_TRI*3];
-static GLfloat  normsTeapotS   [GLUT_SOLID_TEAPOT_N_VERT*3];
-static GLfloat  vertsTeapotS   [GLUT_SOLID_TEAPOT_N_VERT*3];
-static GLfloat  texcsTeapotS   [GLUT_SOLID_TEAPOT_N_VERT*2];
-static GLfloat  lastScaleTeapotS = 0.f;
-static GLboolean initedTeapotS   = GL_FALSE;
-
-static GLushort vertIdxsTeapotW[GLUT_WIRE_TEAPOT_N_VERT*2];
-static GLfloat  normsTeapotW   [GLUT_WIRE_TEAPOT_N_VERT*3];
-static GLfloat  vertsTeapotW   [GLUT_WIRE_TEAPOT_N_VERT*3];
-static GLfloat  lastScaleTeapotW = 0.f;
-static GLboolean initedTeapotW   = GL_FALSE;
-
+#define GLUT_TEAPOT_N_PATCHES       (6*4 + 4*2)     /* 6 patches are reproduced (rotated) 4 times, 4 patches (flipped) 2 times */
 
 /* Teacup defs */
-#define GLUT_TEACUP_N_PATCHES       (6*4 + 1*2)                                                                     /* 6 patches are reproduced (rotated) 4 times, 1 patch (flipped) 2 times */
-#define GLUT_SOLID_TEACUP_N_VERT    GLUT_SOLID_N_SUBDIV*GLUT_SOLID_N_SUBDIV * GLUT_TEACUP_N_PATCHES                 /* N_SUBDIV^2 vertices per patch */
-#define GLUT_SOLID_TEACUP_N_TRI     (GLUT_SOLID_N_SUBDIV-1)*(GLUT_SOLID_N_SUBDIV-1) * GLUT_TEACUP_N_PATCHES * 2     /* if e.g. 7x7 vertices for each patch, there are 6*6 squares for each patch. Each square is decomposed into 2 triangles */
-
-#define GLUT_WIRE_TEACUP_N_VERT     GLUT_WIRE_N_SUBDIV*GLUT_WIRE_N_SUBDIV * GLUT_TEACUP_N_PATCHES                   /* N_SUBDIV^2 vertices per patch */
-
-/* Bit of caching:
- * vertex indices and normals only need to be generated once for
- * a given number of subdivisions as they don't change with scale.
- * Vertices can be cached and reused if scale didn't change.
- */
-static GLushort vertIdxsTeacupS[GLUT_SOLID_TEACUP_N_TRI*3];
-static GLfloat  normsTeacupS   [GLUT_SOLID_TEACUP_N_VERT*3];
-static GLfloat  vertsTeacupS   [GLUT_SOLID_TEACUP_N_VERT*3];
-static GLfloat  texcsTeacupS   [GLUT_SOLID_TEACUP_N_VERT*2];
-static GLfloat  lastScaleTeacupS = 0.f;
-static GLboolean initedTeacupS   = GL_FALSE;
-
-static GLushort vertIdxsTeacupW[GLUT_WIRE_TEACUP_N_VERT*2];
-static GLfloat  normsTeacupW   [GLUT_WIRE_TEACUP_N_VERT*3];
-static GLfloat  vertsTeacupW   [GLUT_WIRE_TEACUP_N_VERT*3];
-static GLfloat  lastScaleTeacupW = 0.f;
-static GLboolean initedTeacupW   = GL_FALSE;
-
+#define GLUT_TEACUP_N_PATCHES       (6*4 + 1*2)     /* 6 patches are reproduced (rotated) 4 times, 1 patch (flipped) 2 times */
 
 /* Teaspoon defs */
 #define GLUT_TEASPOON_N_PATCHES     GLUT_TEASPOON_N_INPUT_PATCHES
-#define GLUT_SOLID_TEASPOON_N_VERT  GLUT_SOLID_N_SUBDIV*GLUT_SOLID_N_SUBDIV * GLUT_TEASPOON_N_PATCHES               /* N_SUBDIV^2 vertices per patch */
-#define GLUT_SOLID_TEASPOON_N_TRI   (GLUT_SOLID_N_SUBDIV-1)*(GLUT_SOLID_N_SUBDIV-1) * GLUT_TEASPOON_N_PATCHES * 2   /* if e.g. 7x7 vertices for each patch, there are 6*6 squares for each patch. Each square is decomposed into 2 triangles */
-
-#define GLUT_WIRE_TEASPOON_N_VERT   GLUT_WIRE_N_SUBDIV*GLUT_WIRE_N_SUBDIV * GLUT_TEASPOON_N_PATCHES                 /* N_SUBDIV^2 vertices per patch */
-
-/* Bit of caching:
- * vertex indices and normals only need to be generated once for
- * a given number of subdivisions as they don't change with scale.
- * Vertices can be cached and reused if scale didn't change.
- */
-static GLushort vertIdxsTeaspoonS[GLUT_SOLID_TEASPOON_N_TRI*3];
-static GLfloat  normsTeaspoonS   [GLUT_SOLID_TEASPOON_N_VERT*3];
-static GLfloat  vertsTeaspoonS   [GLUT_SOLID_TEASPOON_N_VERT*3];
-static GLfloat  texcsTeaspoonS   [GLUT_SOLID_TEASPOON_N_VERT*2];
-static GLfloat  lastScaleTeaspoonS = 0.f;
-static GLboolean initedTeaspoonS   = GL_FALSE;
-
-static GLushort vertIdxsTeaspoonW[GLUT_WIRE_TEASPOON_N_VERT*2];
-static GLfloat  normsTeaspoonW   [GLUT_WIRE_TEASPOON_N_VERT*3];
-static GLfloat  vertsTeaspoonW   [GLUT_WIRE_TEASPOON_N_VERT*3];
-static GLfloat  lastScaleTeaspoonW = 0.f;
-static GLboolean initedTeaspoonW   = GL_FALSE;
 
 
 
 /* -- PRIVATE FUNCTIONS ---------------------------------------------------- */
-extern void fghDrawGeometrySolid(GLfloat *vertices, GLfloat *normals, GLfloat *textcs, GLsizei numVertices,
-                                 GLushort *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart);
-extern void fghDrawGeometryWire(GLfloat *vertices, GLfloat *normals, GLsizei numVertices,
-                                GLushort *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
-                                GLushort *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2);
+extern GLboolean fghDrawCachedGeometry(const SFG_GeometryKey *key);
+extern void fghInitGeometryKey(SFG_GeometryKey *key, fgShape shape, GLboolean useWireMode,
+                               double param0, double param1, double param2, double param3, double param4);
+extern SFG_Mesh *fghLookupMesh(fgShape shape, GLboolean useWireMode, GLfloat param, GLint subdiv1, GLint subdiv2);
+extern SFG_Mesh *fghCreateMesh(fgShape shape, GLboolean useWireMode, GLfloat param, GLint subdiv1, GLint subdiv2,
+                               GLfloat *vertices, GLfloat *normals, int nVert);
+extern void fghSetMeshWire(SFG_Mesh *mesh,
+                           GLuint *vertIdxs, GLsizei numParts, GLsizei numVertPerPart, GLenum vertexMode,
+                           GLuint *vertIdxs2, GLsizei numParts2, GLsizei numVertPerPart2);
+extern void fghSetMeshSolid(SFG_Mesh *mesh, GLuint *vertIdxs, GLsizei numParts, GLsizei numVertIdxsPerPart);
+extern void fghCacheMesh(SFG_Mesh *mesh, GLboolean cacheable);
+extern void fghDrawMesh(const SFG_GeometryKey *key, SFG_Mesh *mesh, GLfloat scaleX, GLfloat scaleY, GLfloat scaleZ);
 
 /* evaluate 3rd order Bernstein polynomial and its 1st deriv */
 static void bernstein3(int i, GLfloat x, GLfloat *r0, GLfloat *r1)
@@ -291,185 +224,185 @@ static int evalBezierWithNorm(GLfloat cp[4][4][3], int nSubDivs, float (*bern_0)
     return nVertVals*flag;
 }
 
-/* verts array should be initialized to 0! */
-static int evalBezier(GLfloat cp[4][4][3], int nSubDivs, float (*bern_0)[4], int flag, GLfloat *verts)
-{
-    int nVerts    = nSubDivs*nSubDivs;
-    int nVertVals = nVerts*3;               /* number of values output for one patch, flag (2 or 4) indicates how many times we will write this to output */
-    int u,v,i,j,o;
-
-    /* generate vertices and coordinates for the patch */
-    for (u=0,o=0; u<nSubDivs; u++)
-    {
-        for (v=0; v<nSubDivs; v++, o+=3)
-        {
-            for (i=0; i<=3; i++)
-            {
-                float vert_0[3]={0};
-                for (j=0; j<=3; j++)
-                {
-                    vert_0[0] += bern_0[v][j] * cp[i][j][0];
-                    vert_0[1] += bern_0[v][j] * cp[i][j][1];
-                    vert_0[2] += bern_0[v][j] * cp[i][j][2];
-                }
-
-                verts[o+0] += bern_0[u][i]*vert_0[0];
-                verts[o+1] += bern_0[u][i]*vert_0[1];
-                verts[o+2] += bern_0[u][i]*vert_0[2];
-            }
-        }
-    }
-
-    /* now based on flag either rotate patches around y axis to other 3 quadrants (flag=4) or reflect patch across x-y plane (flag=2) */
-    rotOrReflect(flag, nVertVals, nSubDivs, verts);
-
-    return nVertVals*flag;
-}
-
-static void fghTeaset( GLfloat scale, GLboolean useWireMode,
-                       GLfloat (*cpdata)[3], int (*patchdata)[16],
-                       GLushort *vertIdxs,
-                       GLfloat *verts, GLfloat *norms, GLfloat *texcs,
-                       GLfloat *lastScale, GLboolean *inited,
-                       GLboolean needNormalFix, GLboolean rotFlip, GLfloat zOffset,
-                       int nVerts, int nInputPatches, int nPatches, int nTriangles )
+/*
+ * Tessellate a teapot, teacup or teaspoon at unit scale, with nSubDivs by
+ * nSubDivs vertices per patch, and hand it to the tessellation cache
+ */
+static SFG_Mesh *fghGenerateTeasetMesh( fgShape shape, GLboolean useWireMode, int nSubDivs,
+                                        GLfloat (*cpdata)[3], int (*patchdata)[16],
+                                        GLboolean needNormalFix, GLboolean rotFlip, GLfloat zOffset,
+                                        int nInputPatches, int nPatches )
 {
     /* for internal use */
-    int p,o;
+    int p,o,r,c;
     GLfloat cp[4][4][3];
-    /* to hold pointers to static vars/arrays */
+    int nVerts    = nSubDivs*nSubDivs*nPatches;
+    int nVertIdxs = useWireMode ? nVerts*2 : (nSubDivs-1)*(nSubDivs-1)*nPatches*6;
     GLfloat (*bern_0)[4], (*bern_1)[4];
-    int nSubDivs;
+    GLfloat *verts, *norms, *texcs = NULL;
+    GLuint   *vertIdxs;
+    SFG_Mesh *mesh;
+
+    bern_0   = malloc(nSubDivs*4*sizeof(GLfloat));
+    bern_1   = malloc(nSubDivs*4*sizeof(GLfloat));
+    verts    = calloc(nVerts*3, sizeof(GLfloat));   /* evalBezierWithNorm needs it set to 0 */
+    norms    = malloc(nVerts*3*sizeof(GLfloat));
+    vertIdxs = malloc(nVertIdxs*sizeof(GLuint));
+    if (!useWireMode)
+        texcs = malloc(nVerts*2*sizeof(GLfloat));
+    if (!bern_0 || !bern_1 || !verts || !norms || !vertIdxs || (!useWireMode && !texcs))
+    {
+        free(bern_0);
+        free(bern_1);
+        free(verts);
+        free(norms);
+        free(vertIdxs);
+        free(texcs);
+        fgError("Failed to allocate memory in fghGenerateTeasetMesh");
+    }
 
-    /* Get relevant static arrays and variables */
-    bern_0      = useWireMode ? bernWire_0                : bernSolid_0;
-    bern_1      = useWireMode ? bernWire_1                : bernSolid_1;
-    nSubDivs    = useWireMode ? GLUT_WIRE_N_SUBDIV        : GLUT_SOLID_N_SUBDIV;
+    /* pregen Berstein polynomials and their first derivatives (for normals) */
+    pregenBernstein(nSubDivs,bern_0,bern_1);
 
-    /* check if need to generate vertices */
-    if (!*inited || scale != *lastScale)
+    /* generate vertices and normals */
+    for (p=0, o=0; p<nInputPatches; p++)
     {
-        /* set vertex array to all 0 (not necessary for normals and vertex indices) */
-        memset(verts,0,nVerts*3*sizeof(GLfloat));
-
-        /* pregen Berstein polynomials and their first derivatives (for normals) */
-        if (!*inited)
-            pregenBernstein(nSubDivs,bern_0,bern_1);
+        /* set flags for evalBezier function */
+        int flag      = rotFlip?p<6?4:2:1;                  /* For teapot and teacup, first six patches get 3 copies (rotations), others get 2 copies (flips). No rotating or flipping at all for teaspoon */
+        int normalFix = needNormalFix?p==3?1:p==5?2:0:0;    /* For teapot, fix normal vectors for vertices on top of lid (patch 4) and on middle of bottom (patch 6). Different flag value as different normal needed */
 
-        /* generate vertices and normals */
-        for (p=0, o=0; p<nInputPatches; p++)
+        /* collect control points */
+        int i;
+        for (i=0; i<16; i++)
         {
-            /* set flags for evalBezier function */
-            int flag      = rotFlip?p<6?4:2:1;                  /* For teapot and teacup, first six patches get 3 copies (rotations), others get 2 copies (flips). No rotating or flipping at all for teaspoon */
-            int normalFix = needNormalFix?p==3?1:p==5?2:0:0;    /* For teapot, fix normal vectors for vertices on top of lid (patch 4) and on middle of bottom (patch 6). Different flag value as different normal needed */
+            /* Original code draws with a 270 rot around X axis, a scaling and a translation along the Z-axis.
+             * Incorporating these in the control points is much cheaper than transforming all the vertices.
+             * Original:
+             * glRotated( 270.0, 1.0, 0.0, 0.0 );
+             * glScaled( 0.5 * scale, 0.5 * scale, 0.5 * scale );
+             * glTranslated( 0.0, 0.0, -zOffset );  -> was 1.5 for teapot, but should be 1.575 to center it on the Z axis. Teacup and teaspoon have different offsets
+             * The scale is applied when drawing, see fghDrawMesh.
+             */
+            cp[i/4][i%4][0] =  cpdata[patchdata[p][i]][0]         /2.f;
+            cp[i/4][i%4][1] = (cpdata[patchdata[p][i]][2]-zOffset)/2.f;
+            cp[i/4][i%4][2] = -cpdata[patchdata[p][i]][1]         /2.f;
+        }
+
+        /* eval bezier patch */
+        o += evalBezierWithNorm(cp,nSubDivs,bern_0,bern_1, flag, normalFix, verts+o,norms+o);
+    }
 
-            /* collect control points */
-            int i;
-            for (i=0; i<16; i++)
+    free(bern_0);
+    free(bern_1);
+
+    /* generate texture coordinates if solid teapot/teacup/teaspoon */
+    if (!useWireMode)
+    {
+        /* generate for first patch */
+        for (r=0,o=0; r<nSubDivs; r++)
+        {
+            GLfloat u = r/(nSubDivs-1.f);
+            for (c=0; c<nSubDivs; c++, o+=2)
             {
-                /* Original code draws with a 270 rot around X axis, a scaling and a translation along the Z-axis.
-                 * Incorporating these in the control points is much cheaper than transforming all the vertices.
-                 * Original:
-                 * glRotated( 270.0, 1.0, 0.0, 0.0 );
-                 * glScaled( 0.5 * scale, 0.5 * scale, 0.5 * scale );
-                 * glTranslated( 0.0, 0.0, -zOffset );  -> was 1.5 for teapot, but should be 1.575 to center it on the Z axis. Teacup and teaspoon have different offsets
-                 */
-                cp[i/4][i%4][0] =  cpdata[patchdata[p][i]][0]         *scale/2.f;
-                cp[i/4][i%4][1] = (cpdata[patchdata[p][i]][2]-zOffset)*scale/2.f;
-                cp[i/4][i%4][2] = -cpdata[patchdata[p][i]][1]         *scale/2.f;
+                GLfloat v = c/(nSubDivs-1.f);
+                texcs[o+0] = u;
+                texcs[o+1] = v;
             }
+        }
+        /* copy it over for all the other patches */
+        for (p=1; p<nPatches; p++)
+            memcpy(texcs+p*nSubDivs*nSubDivs*2,texcs,nSubDivs*nSubDivs*2*sizeof(GLfloat));
+    }
 
-            /* eval bezier patch */
-            if (!*inited)   /* first time, generate normals as well */
-                o += evalBezierWithNorm(cp,nSubDivs,bern_0,bern_1, flag, normalFix, verts+o,norms+o);
-            else            /* only need to regen vertices */
-                o += evalBezier(cp,nSubDivs,bern_0, flag, verts+o);
+    /* build vertex index array */
+    if (useWireMode)
+    {
+        /* build vertex indices to draw teapot/teacup/teaspoon as line strips */
+        /* first strips along increasing u, constant v */
+        for (p=0, o=0; p<nPatches; p++)
+        {
+            int idx = nSubDivs*nSubDivs*p;
+            for (c=0; c<nSubDivs; c++)
+                for (r=0; r<nSubDivs; r++, o++)
+                    vertIdxs[o] = idx+r*nSubDivs+c;
         }
-        *lastScale = scale;
 
-        if (!*inited)
+        /* then strips along increasing v, constant u */
+        for (p=0; p<nPatches; p++) /* don't reset o, we continue appending! */
         {
-            int r,c;
-            /* generate texture coordinates if solid teapot/teacup/teaspoon */
-            if (!useWireMode)
+            int idx = nSubDivs*nSubDivs*p;
+            for (r=0; r<nSubDivs; r++)
             {
-                /* generate for first patch */
-                for (r=0,o=0; r<nSubDivs; r++)
-                {
-                    GLfloat u = r/(nSubDivs-1.f);
-                    for (c=0; c<nSubDivs; c++, o+=2)
-                    {
-                        GLfloat v = c/(nSubDivs-1.f);
-                        texcs[o+0] = u;
-                        texcs[o+1] = v;
-                    }
-                }
-                /* copy it over for all the other patches */
-                for (p=1; p<nPatches; p++)
-                    memcpy(texcs+p*nSubDivs*nSubDivs*2,texcs,nSubDivs*nSubDivs*2*sizeof(GLfloat));
+                int loc = r*nSubDivs;
+                for (c=0; c<nSubDivs; c++, o++)
+                    vertIdxs[o] = idx+loc+c;
             }
-
-            /* build vertex index array */
-            if (useWireMode)
+        }
+    }
+    else
+    {
+        /* build vertex indices to draw teapot/teacup/teaspoon as triangles */
+        for (p=0,o=0; p<nPatches; p++)
+        {
+            int idx = nSubDivs*nSubDivs*p;
+            for (r=0; r<nSubDivs-1; r++)
             {
-                /* build vertex indices to draw teapot/teacup/teaspoon as line strips */
-                /* first strips along increasing u, constant v */
-                for (p=0, o=0; p<nPatches; p++)
+                int loc = r*nSubDivs;
+                for (c=0; c<nSubDivs-1; c++, o+=6)
                 {
-                    int idx = nSubDivs*nSubDivs*p;
-                    for (c=0; c<nSubDivs; c++)
-                        for (r=0; r<nSubDivs; r++, o++)
-                            vertIdxs[o] = idx+r*nSubDivs+c;
-                }
+                    /* ABC ACD, where B and C are one row lower */
+                    int row1 = idx+loc+c;
+                    int row2 = row1+nSubDivs;
 
-                /* then strips along increasing v, constant u */
-                for (p=0; p<nPatches; p++) /* don't reset o, we continue appending! */
-                {
-                    int idx = nSubDivs*nSubDivs*p;
-                    for (r=0; r<nSubDivs; r++)
-                    {
-                        int loc = r*nSubDivs;
-                        for (c=0; c<nSubDivs; c++, o++)
-                            vertIdxs[o] = idx+loc+c;
-                    }
-                }
-            }
-            else
-            {
-                /* build vertex indices to draw teapot/teacup/teaspoon as triangles */
-                for (p=0,o=0; p<nPatches; p++)
-                {
-                    int idx = nSubDivs*nSubDivs*p;
-                    for (r=0; r<nSubDivs-1; r++)
-                    {
-                        int loc = r*nSubDivs;
-                        for (c=0; c<nSubDivs-1; c++, o+=6)
-                        {
-                            /* ABC ACD, where B and C are one row lower */
-                            int row1 = idx+loc+c;
-                            int row2 = row1+nSubDivs;
-
-                            vertIdxs[o+0] = row1+0;
-                            vertIdxs[o+1] = row2+0;
-                            vertIdxs[o+2] = row2+1;
-
-                            vertIdxs[o+3] = row1+0;
-                            vertIdxs[o+4] = row2+1;
-                            vertIdxs[o+5] = row1+1;
-                        }
-                    }
+                    vertIdxs[o+0] = row1+0;
+                    vertIdxs[o+1] = row2+0;
+                    vertIdxs[o+2] = row2+1;
+
+                    vertIdxs[o+3] = row1+0;
+                    vertIdxs[o+4] = row2+1;
+                    vertIdxs[o+5] = row1+1;
                 }
             }
-
-            *inited = GL_TRUE;
         }
     }
 
-    /* draw */
+    /* store in mesh */
+    mesh = fghCreateMesh(shape,useWireMode,0.f,nSubDivs,0,verts,norms,nVerts);
+    mesh->Textcs = texcs;
     if (useWireMode)
-        fghDrawGeometryWire (verts, norms,        nVerts, vertIdxs, nPatches*nSubDivs*2, nSubDivs, GL_LINE_STRIP, NULL,0,0);
+        fghSetMeshWire(mesh,vertIdxs,nPatches*nSubDivs*2,nSubDivs,GL_LINE_STRIP,NULL,0,0);
     else
-        fghDrawGeometrySolid(verts, norms, texcs, nVerts, vertIdxs,1,nTriangles*3);
+        fghSetMeshSolid(mesh,vertIdxs,1,nVertIdxs);
+
+    fghCacheMesh(mesh,GL_TRUE);
+    return mesh;
+}
+
+static void fghTeaset( fgShape shape, GLfloat scale, GLboolean useWireMode,
+                       GLfloat (*cpdata)[3], int (*patchdata)[16],
+                       GLboolean needNormalFix, GLboolean rotFlip, GLfloat zOffset,
+                       int nInputPatches, int nPatches )
+{
+    int nSubDivs = useWireMode ? fgState.TeasetWireSubdivs : fgState.TeasetSolidSubdivs;
+    SFG_GeometryKey key;
+    SFG_Mesh *mesh;
+
+    /* Without 32-bit indices, stay within what 16-bit ones can address */
+    if (!fgState.HasUintIndices && nPatches*nSubDivs*nSubDivs > 65536)
+        nSubDivs = (int)sqrt(65536.0/nPatches);
+
+    /* With OpenGL 2.0, the shape may still be in buffers from an earlier draw
+     * at this scale, then there's nothing to generate nor upload.
+     */
+    fghInitGeometryKey(&key, shape, useWireMode, scale, nSubDivs, 0, 0, 0);
+    if (fghDrawCachedGeometry(&key))
+        return;
+
+    mesh = fghLookupMesh(shape,useWireMode,0.f,nSubDivs,0);
+    if (!mesh)
+        mesh = fghGenerateTeasetMesh(shape,useWireMode,nSubDivs,cpdata,patchdata,
+                                     needNormalFix,rotFlip,zOffset,nInputPatches,nPatches);
+    fghDrawMesh(&key,mesh,scale,scale,scale);
 }
 
 
@@ -481,13 +414,10 @@ static void fghTeaset( GLfloat scale, GLboolean useWireMode,
 void FGAPIENTRY glutWireTeapot( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireTeapot" );
-    fghTeaset( (GLfloat)size, GL_TRUE,
+    fghTeaset( FG_SHAPE_TEAPOT, (GLfloat)size, GL_TRUE,
                cpdata_teapot, patchdata_teapot,
-               vertIdxsTeapotW,
-               vertsTeapotW, normsTeapotW, NULL,
-               &lastScaleTeapotW, &initedTeapotW,
                GL_TRUE, GL_TRUE, 1.575f,
-               GLUT_WIRE_TEAPOT_N_VERT, GLUT_TEAPOT_N_INPUT_PATCHES, GLUT_TEAPOT_N_PATCHES, 0);
+               GLUT_TEAPOT_N_INPUT_PATCHES, GLUT_TEAPOT_N_PATCHES);
 }
 
 /*
@@ -496,13 +426,10 @@ void FGAPIENTRY glutWireTeapot( double size )
 void FGAPIENTRY glutSolidTeapot( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidTeapot" );
-    fghTeaset( (GLfloat)size, GL_FALSE,
+    fghTeaset( FG_SHAPE_TEAPOT, (GLfloat)size, GL_FALSE,
                cpdata_teapot, patchdata_teapot,
-               vertIdxsTeapotS,
-               vertsTeapotS, normsTeapotS, texcsTeapotS,
-               &lastScaleTeapotS, &initedTeapotS,
                GL_TRUE, GL_TRUE, 1.575f,
-               GLUT_SOLID_TEAPOT_N_VERT, GLUT_TEAPOT_N_INPUT_PATCHES, GLUT_TEAPOT_N_PATCHES, GLUT_SOLID_TEAPOT_N_TRI);
+               GLUT_TEAPOT_N_INPUT_PATCHES, GLUT_TEAPOT_N_PATCHES);
 }
 
 
@@ -512,13 +439,10 @@ void FGAPIENTRY glutSolidTeapot( double size )
 void FGAPIENTRY glutWireTeacup( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireTeacup" );
-    fghTeaset( (GLfloat)size/2.5f, GL_TRUE,
+    fghTeaset( FG_SHAPE_TEACUP, (GLfloat)size/2.5f, GL_TRUE,
                cpdata_teacup, patchdata_teacup,
-               vertIdxsTeacupW,
-               vertsTeacupW, normsTeacupW, NULL,
-               &lastScaleTeacupW, &initedTeacupW,
                GL_FALSE, GL_TRUE, 1.5121f,
-               GLUT_WIRE_TEACUP_N_VERT, GLUT_TEACUP_N_INPUT_PATCHES, GLUT_TEACUP_N_PATCHES, 0);
+               GLUT_TEACUP_N_INPUT_PATCHES, GLUT_TEACUP_N_PATCHES);
 }
 
 /*
@@ -527,13 +451,10 @@ void FGAPIENTRY glutWireTeacup( double size )
 void FGAPIENTRY glutSolidTeacup( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidTeacup" );
-    fghTeaset( (GLfloat)size/2.5f, GL_FALSE,
+    fghTeaset( FG_SHAPE_TEACUP, (GLfloat)size/2.5f, GL_FALSE,
                cpdata_teacup, patchdata_teacup,
-               vertIdxsTeacupS,
-               vertsTeacupS, normsTeacupS, texcsTeacupS,
-               &lastScaleTeacupS, &initedTeacupS,
                GL_FALSE, GL_TRUE, 1.5121f,
-               GLUT_SOLID_TEACUP_N_VERT, GLUT_TEACUP_N_INPUT_PATCHES, GLUT_TEACUP_N_PATCHES, GLUT_SOLID_TEACUP_N_TRI);
+               GLUT_TEACUP_N_INPUT_PATCHES, GLUT_TEACUP_N_PATCHES);
 }
 
 
@@ -543,13 +464,10 @@ void FGAPIENTRY glutSolidTeacup( double size )
 void FGAPIENTRY glutWireTeaspoon( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutWireTeaspoon" );
-    fghTeaset( (GLfloat)size/2.5f, GL_TRUE,
+    fghTeaset( FG_SHAPE_TEASPOON, (GLfloat)size/2.5f, GL_TRUE,
                cpdata_teaspoon, patchdata_teaspoon,
-               vertIdxsTeaspoonW,
-               vertsTeaspoonW, normsTeaspoonW, NULL,
-               &lastScaleTeaspoonW, &initedTeaspoonW,
                GL_FALSE, GL_FALSE, -0.0315f,
-               GLUT_WIRE_TEASPOON_N_VERT, GLUT_TEASPOON_N_INPUT_PATCHES, GLUT_TEASPOON_N_PATCHES, 0);
+               GLUT_TEASPOON_N_INPUT_PATCHES, GLUT_TEASPOON_N_PATCHES);
 }
 
 /*
@@ -558,13 +476,10 @@ void FGAPIENTRY glutWireTeaspoon( double size )
 void FGAPIENTRY glutSolidTeaspoon( double size )
 {
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutSolidTeaspoon" );
-    fghTeaset( (GLfloat)size/2.5f, GL_FALSE,
+    fghTeaset( FG_SHAPE_TEASPOON, (GLfloat)size/2.5f, GL_FALSE,
                cpdata_teaspoon, patchdata_teaspoon,
-               vertIdxsTeaspoonS,
-               vertsTeaspoonS, normsTeaspoonS, texcsTeaspoonS,
-               &lastScaleTeaspoonS, &initedTeaspoonS,
                GL_FALSE, GL_FALSE, -0.0315f,
-               GLUT_SOLID_TEASPOON_N_VERT, GLUT_TEASPOON_N_INPUT_PATCHES, GLUT_TEASPOON_N_PATCHES, GLUT_SOLID_TEASPOON_N_TRI);
+               GLUT_TEASPOON_N_INPUT_PATCHES, GLUT_TEASPOON_N_PATCHES);
 }
 
 /*** END OF FILE ***/
@@ -150,10 +150,12 @@ void fgOpenWindow( SFG_Window* window, const char* title,
     window->Window.attribute_v_coord = -1;
     window->Window.attribute_v_normal = -1;
     window->Window.attribute_v_texture = -1;
+    window->Window.attribute_i_matrix = -1;
+    window->Window.attribute_i_color = -1;
 
     fgInitGL2();
 
-    window->State.WorkMask |= GLUT_INIT_WORK;
+    fgAddToWindowWorkList( window, GLUT_INIT_WORK );
 }
 
 /*
@@ -185,12 +187,21 @@ int FGAPIENTRY glutCreateWindow( const char* title )
      * XXX Steve Baker, 12/16/04, 4:22 PM CST, "Re: [Freeglut-developer]
      * XXX Desired 'freeglut' behaviour when there is no current window")
      */
+    SFG_Window* window;
+
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutCreateWindow" );
 
-    return fgCreateWindow( NULL, title, 
-                           fgState.Position.Use, fgState.Position.X, fgState.Position.Y,
-                           fgState.Size.Use, fgState.Size.X, fgState.Size.Y,
-                           GL_FALSE, GL_FALSE )->ID;
+    fgStartupPhase( NULL );
+    window = fgCreateWindow( NULL, title, 
+                             fgState.Position.Use, fgState.Position.X, fgState.Position.Y,
+                             fgState.Size.Use, fgState.Size.X, fgState.Size.Y,
+                             GL_FALSE, GL_FALSE );
+    fgStartupPhase( "rest of glutCreateWindow" );
+
+    /* Startup is over once the first window is up */
+    fgState.StartupTiming = GL_FALSE;
+
+    return window->ID;
 }
 
 /*
@@ -320,10 +331,10 @@ void FGAPIENTRY glutShowWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutShowWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutShowWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_VISIBILITY_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_VISIBILITY_WORK );
     fgStructure.CurrentWindow->State.DesiredVisibility = DesireNormalState;
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_DISPLAY_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_DISPLAY_WORK );
 }
 
 /*
@@ -334,7 +345,7 @@ void FGAPIENTRY glutHideWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutHideWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutHideWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_VISIBILITY_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_VISIBILITY_WORK );
     fgStructure.CurrentWindow->State.DesiredVisibility = DesireHiddenState;
 
     fgStructure.CurrentWindow->State.WorkMask &= ~GLUT_DISPLAY_WORK;
@@ -348,7 +359,7 @@ void FGAPIENTRY glutIconifyWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutIconifyWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutIconifyWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_VISIBILITY_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_VISIBILITY_WORK );
     fgStructure.CurrentWindow->State.DesiredVisibility = DesireIconicState;
 
     fgStructure.CurrentWindow->State.WorkMask &= ~GLUT_DISPLAY_WORK;
@@ -395,7 +406,7 @@ void FGAPIENTRY glutReshapeWindow( int width, int height )
       glutLeaveFullScreen();
     }
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_SIZE_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_SIZE_WORK );
     fgStructure.CurrentWindow->State.DesiredWidth  = width ;
     fgStructure.CurrentWindow->State.DesiredHeight = height;
 }
@@ -414,7 +425,7 @@ void FGAPIENTRY glutPositionWindow( int x, int y )
       glutLeaveFullScreen();
     }
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_POSITION_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_POSITION_WORK );
     fgStructure.CurrentWindow->State.DesiredXpos = x;
     fgStructure.CurrentWindow->State.DesiredYpos = y;
 }
@@ -427,7 +438,7 @@ void FGAPIENTRY glutPushWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPushWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutPushWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_ZORDER_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_ZORDER_WORK );
     fgStructure.CurrentWindow->State.DesiredZOrder = -1;
 }
 
@@ -439,7 +450,7 @@ void FGAPIENTRY glutPopWindow( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutPopWindow" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutPopWindow" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_ZORDER_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_ZORDER_WORK );
     fgStructure.CurrentWindow->State.DesiredZOrder = 1;
 }
 
@@ -473,7 +484,7 @@ void FGAPIENTRY glutFullScreen( void )
     }
 
     if (!win->State.IsFullscreen)
-        win->State.WorkMask |= GLUT_FULL_SCREEN_WORK;
+        fgAddToWindowWorkList( win, GLUT_FULL_SCREEN_WORK );
 }
 
 /*
@@ -485,7 +496,7 @@ void FGAPIENTRY glutLeaveFullScreen( void )
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutFullScreen" );
 
     if (fgStructure.CurrentWindow->State.IsFullscreen)
-        fgStructure.CurrentWindow->State.WorkMask |= GLUT_FULL_SCREEN_WORK;
+        fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_FULL_SCREEN_WORK );
 }
 
 /*
@@ -496,7 +507,7 @@ void FGAPIENTRY glutFullScreenToggle( void )
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutFullScreenToggle" );
     FREEGLUT_EXIT_IF_NO_WINDOW ( "glutFullScreenToggle" );
 
-    fgStructure.CurrentWindow->State.WorkMask |= GLUT_FULL_SCREEN_WORK;
+    fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_FULL_SCREEN_WORK );
 }
 
 /*
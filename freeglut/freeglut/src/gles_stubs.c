@@ -47,3 +47,7 @@ int     glutBitmapHeight( void* font ) { return 0; }
 GLfloat glutStrokeHeight( void* font ) { return 0; }
 void    glutBitmapString( void* font, const unsigned char *string ) {}
 void    glutStrokeString( void* font, const unsigned char *string ) {}
+void    glutResetStrokePen( void ) {}
+
+void fgDestroyFontTextures( SFG_Window *window ) {}
+void fgDestroyStrokeFonts( void ) {}
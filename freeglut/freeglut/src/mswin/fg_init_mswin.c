@@ -48,6 +48,7 @@ void fgPlatformInitialize( const char* displayName )
     /* What we need to do is to initialize the fgDisplay global structure here. */
     fgDisplay.pDisplay.Instance = GetModuleHandle( NULL );
     fgDisplay.pDisplay.DisplayName= displayName ? strdup(displayName) : 0 ;
+    fgDisplay.pDisplay.MainThreadId = GetCurrentThreadId( );
     atom = GetClassInfo( fgDisplay.pDisplay.Instance, _T("FREEGLUT"), &wc );
 
     if( atom == 0 )
@@ -477,13 +477,59 @@ fg_time_t fgPlatformSystemTime ( void )
 
     lastTime32 = currTime32;
 
-    return currTime32 | timeEpoch << 32;
+    return ( currTime32 | timeEpoch << 32 ) * 1000;
 }
 
 
-void fgPlatformSleepForEvents( fg_time_t msec )
+void fgPlatformSleepForEvents( fg_time_t usec )
+{
+    /* Round up, so that we don't wake up just short of a timer */
+    MsgWaitForMultipleObjects( 0, NULL, FALSE, (DWORD) ( ( usec + 999 ) / 1000 ), QS_ALLINPUT );
+}
+
+/*
+ * Called from other threads: a thread message ends the wait above, and is
+ * then dropped by DispatchMessage() as it has no window.
+ */
+void fgPlatformWakeMainLoop( void )
+{
+    PostThreadMessage( fgDisplay.pDisplay.MainThreadId, WM_NULL, 0, 0 );
+}
+
+/*
+ * glutAddInputFd() isn't supported: sockets and file handles don't mix
+ * with MsgWaitForMultipleObjects() the way descriptors do with poll().
+ */
+GLboolean fgPlatformAddInputFd( int fd, int events, GLboolean isNew )
+{
+    return GL_FALSE;
+}
+
+void fgPlatformRemoveInputFd( int fd )
+{
+}
+
+void fgPlatformProcessInputFds( void )
+{
+}
+
+/*
+ * There are no descriptors for glutGetEventFds(): applications wait for
+ * the thread's messages, with MsgWaitForMultipleObjects() for instance.
+ */
+int fgPlatformGetEventFds( int *fds, int *events, int maxFds )
+{
+    return 0;
+}
+
+/* Messages already in the queue don't end a wait for new ones */
+GLboolean fgPlatformHasPendingEvents( void )
+{
+    return HIWORD( GetQueueStatus( QS_ALLINPUT ) ) != 0;
+}
+
+void fgPlatformDrainEventFds( void )
 {
-    MsgWaitForMultipleObjects( 0, NULL, FALSE, (DWORD) msec, QS_ALLINPUT );
 }
 
 
@@ -1078,7 +1124,7 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
         if (wParam)
         {
             fghPlatformOnWindowStatusNotify(window, GL_TRUE, GL_FALSE);
-            window->State.WorkMask |= GLUT_DISPLAY_WORK;
+            fgAddToWindowWorkList( window, GLUT_DISPLAY_WORK );
         }
         else
         {
@@ -1104,7 +1150,7 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
             BeginPaint( hWnd, &ps );
             EndPaint( hWnd, &ps );
 
-            window->State.WorkMask |= GLUT_DISPLAY_WORK;
+            fgAddToWindowWorkList( window, GLUT_DISPLAY_WORK );
         }
         lRet = 0;   /* As per docs, should return 0 */
     }
@@ -1396,7 +1442,7 @@ LRESULT CALLBACK fgPlatformWindowProc( HWND hWnd, UINT uMsg, WPARAM wParam, LPAR
 #if !defined(_WIN32_WCE)
     case WM_SYNCPAINT:  /* 0x0088 */
         /* Another window has moved, need to update this one */
-        window->State.WorkMask |= GLUT_DISPLAY_WORK;
+        fgAddToWindowWorkList( window, GLUT_DISPLAY_WORK );
         lRet = DefWindowProc( hWnd, uMsg, wParam, lParam );
         /* Help screen says this message must be passed to "DefWindowProc" */
         break;
@@ -1663,7 +1709,7 @@ void fgPlatformPosResZordWork(SFG_Window* window, unsigned int workMask)
             rect = mi.rcMonitor;
 
             /* then setup window resize, overwriting other work queued on the window */
-            window->State.WorkMask |= GLUT_POSITION_WORK | GLUT_SIZE_WORK;
+            fgAddToWindowWorkList( window, GLUT_POSITION_WORK | GLUT_SIZE_WORK );
             window->State.WorkMask &= ~GLUT_ZORDER_WORK;
             window->State.DesiredXpos   = rect.left;
             window->State.DesiredYpos   = rect.top;
@@ -33,6 +33,10 @@
 
 void fgPlatformInitialiseInputDevices( void );
 void fgPlatformCloseInputDevices( void );
+void fgPlatformInitialiseWakeup( void );
+void fgPlatformCloseWakeup( void );
+void fgPlatformInitialiseInputFds( void );
+void fgPlatformCloseInputFds( void );
 
 
 static void fghRegistryGlobal( void* data,
@@ -99,6 +103,12 @@ void fgPlatformInitialize( const char* displayName )
 
     fghPlatformInitializeEGL();
 
+    /* For glutWakeMainLoop() and friends */
+    fgPlatformInitialiseWakeup();
+
+    /* For glutAddInputFd() */
+    fgPlatformInitialiseInputFds();
+
     /* Get start time */
     fgState.Time = fgSystemTime();
 
@@ -130,5 +140,8 @@ void fgPlatformCloseDisplay ( void )
     wl_registry_destroy( fgDisplay.pDisplay.registry );
 
     wl_display_disconnect( fgDisplay.pDisplay.display );
+
+    fgPlatformCloseWakeup();
+    fgPlatformCloseInputFds();
 }
 
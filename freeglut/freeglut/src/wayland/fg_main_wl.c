@@ -25,6 +25,13 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+/* ppoll() is a GNU extension, and has to be asked for before any system
+ * header gets included.
+ */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
 #include <GL/freeglut.h>
 #include "../fg_internal.h"
 #include <errno.h>
@@ -38,6 +45,12 @@ void fgPlatformPopWindow( SFG_Window *window );
 void fgPlatformHideWindow( SFG_Window *window );
 void fgPlatformIconifyWindow( SFG_Window *window );
 void fgPlatformShowWindow( SFG_Window *window );
+void fgPlatformWakeupDrain( void );
+struct pollfd *fgPlatformBuildEventFds( int connectionFd, short connectionEvents,
+                                        const int *extraFds, int numExtraFds,
+                                        int *numFds, int *wakeupIndex, const char *caller );
+int fgPlatformCopyEventFds( const struct pollfd *pfds, int numFds,
+                            int *fds, int *events, int maxFds );
 
 
 fg_time_t fgPlatformSystemTime( void )
@@ -45,29 +58,83 @@ fg_time_t fgPlatformSystemTime( void )
 #ifdef CLOCK_MONOTONIC
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
-    return now.tv_nsec/1000000 + now.tv_sec*1000;
+    return now.tv_nsec/1000 + (fg_time_t)now.tv_sec*1000000;
 #elif defined(HAVE_GETTIMEOFDAY)
     struct timeval now;
     gettimeofday( &now, NULL );
-    return now.tv_usec/1000 + now.tv_sec*1000;
+    return now.tv_usec + (fg_time_t)now.tv_sec*1000000;
 #endif
 }
 
-void fgPlatformSleepForEvents( fg_time_t msec )
+/*
+ * The descriptors the main loop waits on, see fgPlatformBuildEventFds()
+ * in x11/fg_inputfd_x11.c: the compositor connection, the wake up
+ * descriptor, then the application's descriptors, which
+ * fgPlatformProcessInputFds() deals with in glutMainLoopEvent()
+ */
+static struct pollfd *fghGetEventFds( int *numFds, int *wakeupIndex, const char *caller )
+{
+    return fgPlatformBuildEventFds( wl_display_get_fd( fgDisplay.pDisplay.display ),
+                                    POLLIN | POLLERR | POLLHUP, NULL, 0,
+                                    numFds, wakeupIndex, caller );
+}
+
+/*
+ * Dispatches what was read from the compositor already, and sends our
+ * requests before we wait. Nothing is left pending after that.
+ */
+GLboolean fgPlatformHasPendingEvents( void )
+{
+    wl_display_dispatch_pending( fgDisplay.pDisplay.display );
+    wl_display_flush( fgDisplay.pDisplay.display );
+    return GL_FALSE;
+}
+
+/*
+ * The descriptors for glutGetEventFds(), with the GLUT_INPUT_* events to
+ * wait for. Returns how many there are, which may be more than maxFds.
+ */
+int fgPlatformGetEventFds( int *fds, int *events, int maxFds )
+{
+    int numFds, wakeupIndex;
+    struct pollfd *pfds = fghGetEventFds( &numFds, &wakeupIndex, "glutGetEventFds()" );
+
+    return fgPlatformCopyEventFds( pfds, numFds, fds, events, maxFds );
+}
+
+/* For glutDispatchReady(), which doesn't know whether we were woken up */
+void fgPlatformDrainEventFds( void )
 {
-    struct pollfd pfd;
+    fgPlatformWakeupDrain( );
+}
+
+void fgPlatformSleepForEvents( fg_time_t usec )
+{
+    int numFds, wakeupIndex;
+    struct pollfd *pfd = fghGetEventFds( &numFds, &wakeupIndex, "glutMainLoopEvent()" );
     int err;
+#ifdef HAVE_PPOLL
+    struct timespec wait;
 
-    pfd.fd = wl_display_get_fd( fgDisplay.pDisplay.display );
-    pfd.events = POLLIN | POLLERR | POLLHUP;
+    wait.tv_sec = usec / 1000000;
+    wait.tv_nsec = (long)(usec % 1000000) * 1000;
+#endif
 
     wl_display_dispatch_pending( fgDisplay.pDisplay.display );
     if ( ! wl_display_flush( fgDisplay.pDisplay.display ) )
     {
-        err = poll( &pfd, 1, msec );
+#ifdef HAVE_PPOLL
+        err = ppoll( pfd, numFds, &wait, NULL );
+#else
+        /* Round up, so that we don't wake up just short of a timer */
+        err = poll( pfd, numFds, (int)( ( usec + 999 ) / 1000 ) );
+#endif
 
         if( ( -1 == err ) && ( errno != EINTR ) )
           fgWarning ( "freeglut poll() error: %d", errno );
+
+        if( err > 0 && wakeupIndex != -1 && pfd[ wakeupIndex ].revents )
+            fgPlatformWakeupDrain( );
     }
 }
 
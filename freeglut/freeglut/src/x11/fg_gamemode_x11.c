@@ -31,18 +31,19 @@
 
 /* we'll try to use XR&R if it's available at compile-time, and at runtime, and the user
  * hasn't explicitly disabled it by setting the FREEGLUT_NO_XRANDR env-var.
+ * The answer is remembered, the extension query is a round trip.
  */
 static int use_xrandr(void)
 {
 #ifdef HAVE_X11_EXTENSIONS_XRANDR_H
+    static int use = -1;
     int event_base, error_base;
-	if(!XRRQueryExtension(fgDisplay.pDisplay.Display, &event_base, &error_base)) {
-		return 0;
+	if(use != -1) {
+		return use;
 	}
-	if(getenv("FREEGLUT_NO_XRANDR")) {
-		return 0;
-	}
-	return 1;
+	use = !getenv("FREEGLUT_NO_XRANDR") &&
+	      XRRQueryExtension(fgDisplay.pDisplay.Display, &event_base, &error_base);
+	return use;
 #else
 	return 0;	/* no compile-time support */
 #endif
@@ -50,18 +51,19 @@ static int use_xrandr(void)
 
 /* we'll try to use XF86VidMode if it's available at compile-time, and at runtime, and the
  * user hasn't explicitly disabled it by setting the FREEGLUT_NO_XF86VM env-var.
+ * The answer is remembered, as for XR&R.
  */
 static int use_xf86vm(void)
 {
 #ifdef HAVE_X11_EXTENSIONS_XF86VMODE_H
+	static int use = -1;
 	int event_base, error_base;
-	if(!XF86VidModeQueryExtension(fgDisplay.pDisplay.Display, &event_base, &error_base)) {
-		return 0;
-	}
-	if(getenv("FREEGLUT_NO_XF86VM")) {
-		return 0;
+	if(use != -1) {
+		return use;
 	}
-	return 1;
+	use = !getenv("FREEGLUT_NO_XF86VM") &&
+	      XF86VidModeQueryExtension(fgDisplay.pDisplay.Display, &event_base, &error_base);
+	return use;
 #else
 	return 0;	/* no compile-time support */
 #endif
@@ -33,11 +33,48 @@
 #include "fg_init.h"
 #include "egl/fg_init_egl.h"
 
-/* Return the atom associated with "name". */
-static Atom fghGetAtom(const char * name)
+extern void fgPlatformDiscardEventBatch( void );
+extern void fgPlatformInitialiseWakeup( void );
+extern void fgPlatformCloseWakeup( void );
+extern void fgPlatformInitialiseInputFds( void );
+extern void fgPlatformCloseInputFds( void );
+
+/*
+ * All the atoms we use, interned with a single XInternAtoms() call at
+ * initialization instead of a round trip to the server for each. Xlib
+ * caches them, so later XInternAtom() calls for these names (for example
+ * the one for WM_PROTOCOLS in XSetWMProtocols()) are free.
+ */
+enum
 {
-  return XInternAtom(fgDisplay.pDisplay.Display, name, False);
-}
+    FGH_ATOM_WM_DELETE_WINDOW,
+    FGH_ATOM_WM_PROTOCOLS,
+    FGH_ATOM_WM_CLIENT_MACHINE,
+    FGH_ATOM_NET_SUPPORTING_WM_CHECK,
+    FGH_ATOM_NET_SUPPORTED,
+    FGH_ATOM_NET_WM_STATE,
+    FGH_ATOM_NET_WM_STATE_FULLSCREEN,
+    FGH_ATOM_NET_WM_PID,
+    FGH_ATOM_NET_FRAME_EXTENTS,
+    FGH_ATOM_MOTIF_WM_HINTS,
+    FGH_NUM_ATOMS
+};
+
+static char *fghAtomNames[ FGH_NUM_ATOMS ] =
+{
+    "WM_DELETE_WINDOW",
+    "WM_PROTOCOLS",
+    "WM_CLIENT_MACHINE",
+    "_NET_SUPPORTING_WM_CHECK",
+    "_NET_SUPPORTED",
+    "_NET_WM_STATE",
+    "_NET_WM_STATE_FULLSCREEN",
+    "_NET_WM_PID",
+    "_NET_FRAME_EXTENTS",
+    "_MOTIF_WM_HINTS"
+};
+
+static Atom fghAtoms[ FGH_NUM_ATOMS ];
 
 /*
  * Check if "property" is set on "window".  The property's values are returned
@@ -101,7 +138,7 @@ static int fghNetWMSupported(void)
 
   net_wm_supported = 0;
 
-  wm_check = fghGetAtom("_NET_SUPPORTING_WM_CHECK");
+  wm_check = fghAtoms[ FGH_ATOM_NET_SUPPORTING_WM_CHECK ];
   window_ptr_1 = malloc(sizeof(Window *));
 
   /*
@@ -166,6 +203,62 @@ int fgHintPresent(Window window, Atom property, Atom hint)
   return supported;
 }
 
+/*
+ * Find out what the window manager supports. This takes a few round trips
+ * and only matters once we have a window, so it is left until then
+ * instead of being done by glutInit().
+ */
+void fgInitialiseNetWM( void )
+{
+    Atom *atoms;
+    int number_of_atoms;
+    int i;
+
+    if( fgDisplay.pDisplay.NetWMInitialised )
+        return;
+    fgDisplay.pDisplay.NetWMInitialised = GL_TRUE;
+
+    fgDisplay.pDisplay.NetWMSupported = fghNetWMSupported();
+
+    if (fgDisplay.pDisplay.NetWMSupported)
+    {
+      const Atom state       = fghAtoms[ FGH_ATOM_NET_WM_STATE ];
+      const Atom full_screen = fghAtoms[ FGH_ATOM_NET_WM_STATE_FULLSCREEN ];
+      GLboolean  has_state = GL_FALSE, has_full_screen = GL_FALSE;
+
+      /*
+       * Check if the state and full screen hints are supported, reading
+       * _NET_SUPPORTED once for both.
+       */
+      /**  Check "_NET_WM_ALLOWED_ACTIONS" on our window instead? **/
+      number_of_atoms = fghGetWindowProperty(fgDisplay.pDisplay.RootWindow,
+                                             fghAtoms[ FGH_ATOM_NET_SUPPORTED ],
+                                             XA_ATOM,
+                                             (unsigned char **) &atoms);
+      for (i = 0; i < number_of_atoms; i++)
+      {
+        if (atoms[i] == state)
+          has_state = GL_TRUE;
+        else if (atoms[i] == full_screen)
+          has_full_screen = GL_TRUE;
+      }
+      XFree(atoms);
+
+      if (has_state)
+      {
+        fgDisplay.pDisplay.State = state;
+
+        if (has_full_screen)
+          fgDisplay.pDisplay.StateFullScreen = full_screen;
+      }
+
+      fgDisplay.pDisplay.NetWMPid = fghAtoms[ FGH_ATOM_NET_WM_PID ];
+      fgDisplay.pDisplay.ClientMachine = fghAtoms[ FGH_ATOM_WM_CLIENT_MACHINE ];
+    }
+
+    fgStartupPhase( "window manager (EWMH) probe" );
+}
+
 /*
  * A call to this function should initialize all the display stuff...
  */
@@ -179,8 +272,11 @@ void fgPlatformInitialize( const char* displayName )
     if ( fgState.XSyncSwitch )
         XSynchronize(fgDisplay.pDisplay.Display, True);
 
+    fgStartupPhase( "XOpenDisplay" );
+
 #ifdef EGL_VERSION_1_0
     fghPlatformInitializeEGL();
+    fgStartupPhase( "EGL initialization" );
 #else
     if( !glXQueryExtension( fgDisplay.pDisplay.Display, NULL, NULL ) )
         fgError( "OpenGL GLX extension not supported by display '%s'",
@@ -193,6 +289,7 @@ void fgPlatformInitialize( const char* displayName )
      */
     glXQueryExtensionsString( fgDisplay.pDisplay.Display,
         DefaultScreen( fgDisplay.pDisplay.Display ));
+    fgStartupPhase( "GLX probe" );
 #endif
 
     fgDisplay.pDisplay.Screen = DefaultScreen( fgDisplay.pDisplay.Display );
@@ -221,40 +318,30 @@ void fgPlatformInitialize( const char* displayName )
 
     fgDisplay.pDisplay.Connection = ConnectionNumber( fgDisplay.pDisplay.Display );
 
-    /* Create the window deletion atom */
-    fgDisplay.pDisplay.DeleteWindow = fghGetAtom("WM_DELETE_WINDOW");
+    /* For glutWakeMainLoop() and friends */
+    fgPlatformInitialiseWakeup( );
 
-    /* Create the state and full screen atoms */
+    /* For glutAddInputFd() */
+    fgPlatformInitialiseInputFds( );
+
+    /* Create all the atoms in one go */
+    if( !XInternAtoms( fgDisplay.pDisplay.Display, fghAtomNames, FGH_NUM_ATOMS,
+                       False, fghAtoms ) )
+        fgError( "failed to create the X atoms" );
+
+    fgDisplay.pDisplay.DeleteWindow    = fghAtoms[ FGH_ATOM_WM_DELETE_WINDOW ];
+    fgDisplay.pDisplay.NetFrameExtents = fghAtoms[ FGH_ATOM_NET_FRAME_EXTENTS ];
+    fgDisplay.pDisplay.MotifWMHints    = fghAtoms[ FGH_ATOM_MOTIF_WM_HINTS ];
+
+    /* The state and full screen atoms are set by fgInitialiseNetWM() */
+    fgDisplay.pDisplay.NetWMInitialised = GL_FALSE;
+    fgDisplay.pDisplay.NetWMSupported  = 0;
     fgDisplay.pDisplay.State           = None;
     fgDisplay.pDisplay.StateFullScreen = None;
     fgDisplay.pDisplay.NetWMPid        = None;
     fgDisplay.pDisplay.ClientMachine   = None;
 
-    fgDisplay.pDisplay.NetWMSupported = fghNetWMSupported();
-
-    if (fgDisplay.pDisplay.NetWMSupported)
-    {
-      const Atom supported = fghGetAtom("_NET_SUPPORTED");
-      const Atom state     = fghGetAtom("_NET_WM_STATE");
-      
-      /* Check if the state hint is supported. */
-      if (fgHintPresent(fgDisplay.pDisplay.RootWindow, supported, state))
-      {
-        const Atom full_screen = fghGetAtom("_NET_WM_STATE_FULLSCREEN");
-        
-        fgDisplay.pDisplay.State = state;
-        
-        /* Check if the window manager supports full screen. */
-        /**  Check "_NET_WM_ALLOWED_ACTIONS" on our window instead? **/
-        if (fgHintPresent(fgDisplay.pDisplay.RootWindow, supported, full_screen))
-        {
-          fgDisplay.pDisplay.StateFullScreen = full_screen;
-        }
-      }
-
-      fgDisplay.pDisplay.NetWMPid = fghGetAtom("_NET_WM_PID");
-      fgDisplay.pDisplay.ClientMachine = fghGetAtom("WM_CLIENT_MACHINE");
-    }
+    fgStartupPhase( "atoms" );
 
     /* Get start time */
     fgState.Time = fgSystemTime();
@@ -290,6 +377,12 @@ void fgPlatformCloseDisplay ( void )
      * created so far
      */
     XCloseDisplay( fgDisplay.pDisplay.Display );
+
+    /* Events read ahead of the display's closing are of no use anymore */
+    fgPlatformDiscardEventBatch( );
+
+    fgPlatformCloseWakeup( );
+    fgPlatformCloseInputFds( );
 }
 
 
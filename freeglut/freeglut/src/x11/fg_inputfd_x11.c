@@ -0,0 +1,297 @@
+/*
+ * fg_inputfd_x11.c
+ *
+ * Waiting on the application's descriptors, see glutAddInputFd(), and
+ * building the main loop's poll() set around them. The Wayland port uses
+ * this too, the code only relies on POSIX descriptors.
+ *
+ * Creation date: Fri Oct 16 2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * PAWEL W. OLSZTA BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <GL/freeglut.h>
+#include "../fg_internal.h"
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_EPOLL_H
+#    include <sys/epoll.h>
+#endif
+
+/* The most ready descriptors handled per main loop iteration with epoll */
+#define FGH_MAX_INPUT_FD_EVENTS 64
+
+extern int fgPlatformWakeupFd( void );
+
+/*
+ * With epoll, the application's descriptors are kept in an epoll set, and
+ * the main loop only has to wait on that set's descriptor, however many
+ * there are. Elsewhere they are all added to the main loop's poll() set.
+ */
+#ifdef HAVE_SYS_EPOLL_H
+static int fghEpollFd = -1;
+#endif
+
+/* The poll() set for fgPlatformProcessInputFds() without epoll */
+static struct pollfd *fghPollFds = NULL;
+static int fghPollFdsSize = 0;
+
+void fgPlatformInitialiseInputFds( void )
+{
+#ifdef HAVE_SYS_EPOLL_H
+    fghEpollFd = epoll_create1( EPOLL_CLOEXEC );
+    if( fghEpollFd == -1 )
+        fgWarning( "can't create the input descriptor epoll set: %d", errno );
+#endif
+}
+
+void fgPlatformCloseInputFds( void )
+{
+#ifdef HAVE_SYS_EPOLL_H
+    if( fghEpollFd != -1 )
+        close( fghEpollFd );
+    fghEpollFd = -1;
+#endif
+
+    free( fghPollFds );
+    fghPollFds = NULL;
+    fghPollFdsSize = 0;
+}
+
+static short fghPollEvents( int events )
+{
+    return ( events & GLUT_INPUT_READABLE ? POLLIN  : 0 ) |
+           ( events & GLUT_INPUT_WRITABLE ? POLLOUT : 0 );
+}
+
+/* Hang ups and errors are readable too, for the application to see them */
+static int fghGlutEvents( int readable, int writable, int error )
+{
+    return ( readable || error ? GLUT_INPUT_READABLE : 0 ) |
+           ( writable          ? GLUT_INPUT_WRITABLE : 0 ) |
+           ( error             ? GLUT_INPUT_ERROR    : 0 );
+}
+
+/*
+ * Starts or changes waiting on fd for the GLUT_INPUT_* events. Returns
+ * GL_FALSE if the descriptor can't be waited on.
+ */
+GLboolean fgPlatformAddInputFd( int fd, int events, GLboolean isNew )
+{
+#ifdef HAVE_SYS_EPOLL_H
+    if( fghEpollFd != -1 )
+    {
+        struct epoll_event event;
+
+        event.events = ( events & GLUT_INPUT_READABLE ? EPOLLIN  : 0 ) |
+                       ( events & GLUT_INPUT_WRITABLE ? EPOLLOUT : 0 );
+        event.data.u64 = 0;
+        event.data.fd = fd;
+        return epoll_ctl( fghEpollFd, isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD,
+                          fd, &event ) == 0;
+    }
+#endif
+
+    /* poll() doesn't mind, and reports bad descriptors with POLLNVAL */
+    return GL_TRUE;
+}
+
+void fgPlatformRemoveInputFd( int fd )
+{
+#ifdef HAVE_SYS_EPOLL_H
+    /* This fails if fd was closed already, which removed it anyway */
+    if( fghEpollFd != -1 )
+        epoll_ctl( fghEpollFd, EPOLL_CTL_DEL, fd, NULL );
+#endif
+}
+
+/*
+ * The number of descriptors fghInputFdsWaitSet() adds to the main loop's
+ * poll() set
+ */
+static int fghInputFdsWaitSize( void )
+{
+    if( !fgState.NumInputFds )
+        return 0;
+#ifdef HAVE_SYS_EPOLL_H
+    if( fghEpollFd != -1 )
+        return 1;
+#endif
+    return fgState.NumInputFds;
+}
+
+/*
+ * Fills in the main loop's poll() set entries for the application's
+ * descriptors, returns how many there are.
+ */
+static int fghInputFdsWaitSet( struct pollfd *pfds )
+{
+    int i;
+
+    if( !fgState.NumInputFds )
+        return 0;
+
+#ifdef HAVE_SYS_EPOLL_H
+    if( fghEpollFd != -1 )
+    {
+        pfds[ 0 ].fd = fghEpollFd;
+        pfds[ 0 ].events = POLLIN;
+        pfds[ 0 ].revents = 0;
+        return 1;
+    }
+#endif
+
+    for( i = 0; i < fgState.NumInputFds; i++ )
+    {
+        pfds[ i ].fd = fgState.InputFds[ i ].Fd;
+        pfds[ i ].events = fghPollEvents( fgState.InputFds[ i ].Events );
+        pfds[ i ].revents = 0;
+    }
+    return fgState.NumInputFds;
+}
+
+/*
+ * Calls back for the application's descriptors that are ready, without
+ * waiting. The callbacks may add and remove descriptors, so work on a
+ * copy of the set.
+ */
+void fgPlatformProcessInputFds( void )
+{
+    int i, numFds, err;
+
+#ifdef HAVE_SYS_EPOLL_H
+    if( fghEpollFd != -1 )
+    {
+        struct epoll_event events[ FGH_MAX_INPUT_FD_EVENTS ];
+
+        numFds = epoll_wait( fghEpollFd, events, FGH_MAX_INPUT_FD_EVENTS, 0 );
+        for( i = 0; i < numFds; i++ )
+            fgDispatchInputFd( events[ i ].data.fd,
+                               fghGlutEvents( events[ i ].events & EPOLLIN,
+                                              events[ i ].events & EPOLLOUT,
+                                              events[ i ].events & ( EPOLLERR | EPOLLHUP ) ) );
+        return;
+    }
+#endif
+
+    numFds = fgState.NumInputFds;
+    if( numFds > fghPollFdsSize )
+    {
+        struct pollfd *pfds = realloc( fghPollFds, numFds * sizeof( struct pollfd ) );
+        if( !pfds )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in glutAddInputFd()" );
+        fghPollFds = pfds;
+        fghPollFdsSize = numFds;
+    }
+
+    fghInputFdsWaitSet( fghPollFds );
+    err = poll( fghPollFds, numFds, 0 );
+
+    for( i = 0; err > 0 && i < numFds; i++ )
+    {
+        short revents = fghPollFds[ i ].revents;
+
+        if( !revents )
+            continue;
+
+        fgDispatchInputFd( fghPollFds[ i ].fd,
+                           fghGlutEvents( revents & POLLIN, revents & POLLOUT,
+                                          revents & ( POLLERR | POLLHUP | POLLNVAL ) ) );
+
+        /* Not a descriptor (any more): don't have every poll() end at once */
+        if( revents & POLLNVAL )
+        {
+            fgWarning( "glutAddInputFd(): descriptor %d was closed, no longer waiting on it",
+                       fghPollFds[ i ].fd );
+            glutRemoveInputFd( fghPollFds[ i ].fd );
+        }
+    }
+}
+
+/*
+ * Builds the poll() set the main loop waits on: the window system
+ * connection, numExtraFds port specific descriptors from index 1, the wake
+ * up descriptor, then the application's descriptors. Stores the set's size
+ * in numFds, and the wake up descriptor's index, or -1, in wakeupIndex.
+ * The set is reused by the next call. caller names the GLUT function for
+ * errors.
+ */
+struct pollfd *fgPlatformBuildEventFds( int connectionFd, short connectionEvents,
+                                        const int *extraFds, int numExtraFds,
+                                        int *numFds, int *wakeupIndex, const char *caller )
+{
+    /* There are more of them than fit on the stack once the application adds its own */
+    static struct pollfd *pollFds = NULL;
+    static int pollFdsSize = 0;
+    int i, size = 2 + numExtraFds + fghInputFdsWaitSize( );
+
+    if( size > pollFdsSize )
+    {
+        struct pollfd *pfds = realloc( pollFds, size * sizeof( struct pollfd ) );
+        if( !pfds )
+            fgError( "Fatal error: "
+                     "Memory allocation failure in %s", caller );
+        pollFds = pfds;
+        pollFdsSize = size;
+    }
+
+    pollFds[ 0 ].fd = connectionFd;
+    pollFds[ 0 ].events = connectionEvents;
+    pollFds[ 0 ].revents = 0;
+    *numFds = 1;
+
+    for( i = 0; i < numExtraFds; i++, ( *numFds )++ )
+    {
+        pollFds[ *numFds ].fd = extraFds[ i ];
+        pollFds[ *numFds ].events = POLLIN;
+        pollFds[ *numFds ].revents = 0;
+    }
+
+    /* Other threads wake us up through this, see fg_wakeup_x11.c */
+    *wakeupIndex = -1;
+    pollFds[ *numFds ].fd = fgPlatformWakeupFd( );
+    pollFds[ *numFds ].events = POLLIN;
+    pollFds[ *numFds ].revents = 0;
+    if( pollFds[ *numFds ].fd != -1 )
+        *wakeupIndex = ( *numFds )++;
+
+    *numFds += fghInputFdsWaitSet( pollFds + *numFds );
+    return pollFds;
+}
+
+/*
+ * Copies a poll() set out for glutGetEventFds(), with the GLUT_INPUT_*
+ * events to wait for. Returns the set's size, which may be more than
+ * maxFds.
+ */
+int fgPlatformCopyEventFds( const struct pollfd *pfds, int numFds,
+                            int *fds, int *events, int maxFds )
+{
+    int i;
+
+    for( i = 0; i < numFds && i < maxFds; i++ )
+    {
+        fds[ i ] = pfds[ i ].fd;
+        if( events )
+            events[ i ] = ( pfds[ i ].events & POLLIN  ? GLUT_INPUT_READABLE : 0 ) |
+                          ( pfds[ i ].events & POLLOUT ? GLUT_INPUT_WRITABLE : 0 );
+    }
+    return numFds;
+}
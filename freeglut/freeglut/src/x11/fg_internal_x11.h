@@ -58,11 +58,14 @@ struct tagSFG_PlatformDisplay
     Window          RootWindow;         /* The screen's root window.         */
     int             Connection;         /* The display's connection number   */
     Atom            DeleteWindow;       /* The window deletion atom          */
+    Atom            MotifWMHints;       /* The _MOTIF_WM_HINTS atom          */
+    GLboolean       NetWMInitialised;   /* The fields below are set?         */
     Atom            State;              /* The state atom                    */
     Atom            StateFullScreen;    /* The full screen atom              */
     int             NetWMSupported;     /* Flag for EWMH Window Managers     */
     Atom            NetWMPid;           /* The _NET_WM_PID atom              */
     Atom            ClientMachine;      /* The client machine name atom      */
+    Atom            NetFrameExtents;    /* The _NET_FRAME_EXTENTS atom       */
 
 #ifdef HAVE_X11_EXTENSIONS_XRANDR_H
     int prev_xsz, prev_ysz;
@@ -117,6 +120,17 @@ struct tagSFG_PlatformWindowState
     int             OldWidth;           /* Window width from before a resize */
     int             OldHeight;          /*   "    height  "    "    "   "    */
     GLboolean       KeyRepeating;       /* Currently in repeat mode?         */    
+
+    /* Window geometry tracked from events for glutGet, see fg_state_x11.c */
+    GLboolean       Reparented;         /* Top-level window in a window manager frame? */
+    GLboolean       PositionValid;      /* X and Y are up to date?           */
+    int             X, Y;               /* Client area, on the root window or the parent's client area */
+    GLboolean       SizeValid;          /* Width and Height are up to date?  */
+    int             Width, Height;
+    GLboolean       FrameValid;         /* FrameLeft and FrameTop are up to date? */
+    int             FrameLeft;          /* GLUT_WINDOW_BORDER_WIDTH          */
+    int             FrameTop;           /* GLUT_WINDOW_HEADER_HEIGHT         */
+    unsigned long   GeometrySerial;     /* Older events predate our last move or resize */
 };
 
 
@@ -216,6 +230,11 @@ void            fgSpaceballHandleXEvent( const XEvent *ev );
  */
 int             fgHintPresent(Window window, Atom property, Atom hint);
 
+/*
+ * Probe the window manager's EWMH support on first use.  See fg_init.c
+ */
+void            fgInitialiseNetWM( void );
+
 /* Handler for X extension Events */
 #ifdef HAVE_X11_EXTENSIONS_XINPUT2_H
   void          fgHandleExtensionEvents( XEvent * ev );
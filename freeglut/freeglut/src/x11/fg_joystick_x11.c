@@ -696,3 +696,38 @@ void fgPlatformJoystickClose ( int ident )
          close( fgJoystick[ ident ]->pJoystick.fd );
 }
 
+
+
+/*
+ * The Linux joystick driver queues events on the device, so the main loop
+ * can wait on it alongside the X connection. Stores the descriptors of the
+ * opened joysticks in fds and returns how many there are.
+ */
+int fgPlatformJoystickGetFds( int *fds, int maxFds )
+{
+    int count = 0;
+#ifdef JS_NEW
+    int ident;
+
+    for( ident = 0; ident < MAX_NUM_JOYSTICKS && count < maxFds; ident++ )
+        if( fgJoystick[ ident ] && !fgJoystick[ ident ]->error )
+            fds[ count++ ] = fgJoystick[ ident ]->pJoystick.fd;
+#endif
+    return count;
+}
+
+/*
+ * Reads the queued joystick events into the cached state, so that the
+ * descriptors stop polling as readable until something new happens.
+ * The joystick callbacks still only see the state at their poll times.
+ */
+void fgPlatformJoystickDrain( void )
+{
+#ifdef JS_NEW
+    int ident;
+
+    for( ident = 0; ident < MAX_NUM_JOYSTICKS; ident++ )
+        if( fgJoystick[ ident ] && !fgJoystick[ ident ]->error )
+            fgPlatformJoystickRawRead( fgJoystick[ ident ], NULL, NULL );
+#endif
+}
@@ -0,0 +1,46 @@
+/*
+ * fg_keyrepeat_x11.c
+ *
+ * Telling auto repeated keys from real ones, from the events alone. It
+ * needs neither a display nor the rest of freeglut, so that the keyrepeat
+ * demo can replay made up event sequences through it.
+ *
+ * Creation date: Fri Oct 16 2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * PAWEL W. OLSZTA BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <GL/freeglut.h>
+#include <X11/Xlib.h>
+
+/*
+ * X11 reports an auto repeated key as a KeyRelease immediately followed by
+ * a KeyPress of the same key, with the same timestamp. Rather than asking
+ * the server whether the key is still held down (XQueryKeymap, a round
+ * trip), look at the event following the release, if it has already been
+ * received. next is NULL if it hasn't. Server timestamps are 32 bits wide
+ * and wrap around, even where Time is longer.
+ */
+GLboolean fgPlatformIsKeyRepeat( const XKeyEvent *release, const XEvent *next )
+{
+    return next &&
+           next->type == KeyPress &&
+           next->xkey.window == release->window &&
+           next->xkey.keycode == release->keycode &&
+           ( ( next->xkey.time - release->time ) & 0xFFFFFFFFUL ) <= 1;
+}
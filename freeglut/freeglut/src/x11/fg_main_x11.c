@@ -26,9 +26,17 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+/* ppoll() is a GNU extension, and has to be asked for before any system
+ * header gets included.
+ */
+#ifndef _GNU_SOURCE
+#    define _GNU_SOURCE
+#endif
+
 #include <GL/freeglut.h>
 #include "../fg_internal.h"
 #include <errno.h>
+#include <poll.h>
 #include <stdarg.h>
 
 
@@ -47,6 +55,9 @@
 #    define MIN(a,b) (((a)<(b)) ? (a) : (b))
 #endif
 
+/* The most joystick descriptors the main loop waits on */
+#define FGH_MAX_JOYSTICK_FDS 8
+
 extern void fghOnReshapeNotify(SFG_Window *window, int width, int height, GLboolean forceNotify);
 extern void fghOnPositionNotify(SFG_Window *window, int x, int y, GLboolean forceNotify);
 extern void fgPlatformFullScreenToggle( SFG_Window *win );
@@ -56,11 +67,39 @@ extern void fgPlatformPushWindow( SFG_Window *window );
 extern void fgPlatformPopWindow( SFG_Window *window );
 extern void fgPlatformHideWindow( SFG_Window *window );
 extern void fgPlatformIconifyWindow( SFG_Window *window );
+extern int fgPlatformJoystickGetFds( int *fds, int maxFds );
+extern void fgPlatformJoystickDrain( void );
+extern void fgPlatformWakeupDrain( void );
+extern struct pollfd *fgPlatformBuildEventFds( int connectionFd, short connectionEvents,
+                                               const int *extraFds, int numExtraFds,
+                                               int *numFds, int *wakeupIndex, const char *caller );
+extern int fgPlatformCopyEventFds( const struct pollfd *pfds, int numFds,
+                                   int *fds, int *events, int maxFds );
 extern void fgPlatformShowWindow( SFG_Window *window );
+extern GLboolean fgPlatformIsKeyRepeat( const XKeyEvent *release, const XEvent *next );
 
 /* used in the event handling code to match and discard stale mouse motion events */
 static Bool match_motion(Display *dpy, XEvent *xev, XPointer arg);
 
+/* used in the event handling code to detect auto repeated keys */
+static GLboolean fghIsKeyRepeat( const XKeyEvent *release );
+
+/* used in the event handling code to read events, coalesced if configured */
+static GLboolean fghNextEvent( XEvent *event );
+
+/* used in the event handling code to remember the geometry glutGet reports */
+static void fghUpdateGeometryCache( SFG_Window *window, const XConfigureEvent *configure );
+
+/*
+ * The events read ahead by fghNextEvent() with GLUT_COALESCE_EVENTS set.
+ * eventBatch[ eventBatchNext ] up to eventBatch[ eventBatchUsed - 1 ] are
+ * still to be dispatched.
+ */
+static XEvent *eventBatch = NULL;
+static int eventBatchSize = 0;
+static int eventBatchUsed = 0;
+static int eventBatchNext = 0;
+
 /*
  * TODO BEFORE THE STABLE RELEASE:
  *
@@ -78,20 +117,41 @@ fg_time_t fgPlatformSystemTime ( void )
 #ifdef CLOCK_MONOTONIC
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
-    return now.tv_nsec/1000000 + now.tv_sec*1000;
+    return now.tv_nsec/1000 + (fg_time_t)now.tv_sec*1000000;
 #elif defined(HAVE_GETTIMEOFDAY)
     struct timeval now;
     gettimeofday( &now, NULL );
-    return now.tv_usec/1000 + now.tv_sec*1000;
+    return now.tv_usec + (fg_time_t)now.tv_sec*1000000;
 #endif
 }
 
 /*
- * Does the magic required to relinquish the CPU until something interesting
- * happens.
+ * The descriptors the main loop waits on, see fgPlatformBuildEventFds():
+ * the X connection, the joysticks from index 1, the wake up descriptor,
+ * then the application's descriptors, which fgPlatformProcessInputFds()
+ * deals with in glutMainLoopEvent()
  */
+static struct pollfd *fghGetEventFds( int *numFds, int *wakeupIndex, int *numJoysticks,
+                                      const char *caller )
+{
+    int fds[ FGH_MAX_JOYSTICK_FDS ];
+
+    /* Wake up when a joystick reports something, instead of letting
+     * its events pile up in the driver until the next poll.
+     */
+    *numJoysticks = 0;
+    if( fgState.NumActiveJoysticks > 0 )
+        *numJoysticks = fgPlatformJoystickGetFds( fds, FGH_MAX_JOYSTICK_FDS );
+
+    return fgPlatformBuildEventFds( ConnectionNumber( fgDisplay.pDisplay.Display ), POLLIN,
+                                    fds, *numJoysticks, numFds, wakeupIndex, caller );
+}
 
-void fgPlatformSleepForEvents( fg_time_t msec )
+/*
+ * Has there been anything read from the X connection that is still to be
+ * processed? Also sends the pending requests, before we wait.
+ */
+GLboolean fgPlatformHasPendingEvents( void )
 {
     /*
      * Possibly due to aggressive use of XFlush() and friends,
@@ -100,24 +160,101 @@ void fgPlatformSleepForEvents( fg_time_t msec )
      * X, anyway?)  We do non-trivial processing of X events
      * after the event-reading loop, in any case, so we
      * need to allow that we may have an empty socket but non-
-     * empty event queue.
+     * empty event queue. The same goes for events read ahead.
      */
-    if( ! XPending( fgDisplay.pDisplay.Display ) )
+    return eventBatchNext != eventBatchUsed || XPending( fgDisplay.pDisplay.Display );
+}
+
+/*
+ * The descriptors for glutGetEventFds(), with the GLUT_INPUT_* events to
+ * wait for. Returns how many there are, which may be more than maxFds.
+ */
+int fgPlatformGetEventFds( int *fds, int *events, int maxFds )
+{
+    int numFds, wakeupIndex, numJoysticks;
+    struct pollfd *pfds = fghGetEventFds( &numFds, &wakeupIndex, &numJoysticks,
+                                          "glutGetEventFds()" );
+
+    return fgPlatformCopyEventFds( pfds, numFds, fds, events, maxFds );
+}
+
+/*
+ * Makes the wake up and joystick descriptors unreadable again, for
+ * glutDispatchReady() which doesn't know which of them were ready.
+ */
+void fgPlatformDrainEventFds( void )
+{
+    fgPlatformWakeupDrain( );
+    if( fgState.NumActiveJoysticks > 0 )
+        fgPlatformJoystickDrain( );
+}
+
+/*
+ * Does the magic required to relinquish the CPU until something interesting
+ * happens.
+ */
+void fgPlatformSleepForEvents( fg_time_t usec )
+{
+    if( ! fgPlatformHasPendingEvents( ) )
     {
-        fd_set fdset;
-        int err;
-        int socket;
+        struct pollfd *pfds;
+        int numFds, wakeupIndex, numJoysticks, err, i;
+        GLboolean wokenUp = GL_FALSE, joystickReady = GL_FALSE;
+#ifdef HAVE_PPOLL
+        /* ppoll() takes a timespec timeout and, unlike select(), isn't
+         * limited to descriptors below FD_SETSIZE.
+         */
+        struct timespec wait;
+#else
+        fd_set readFds, writeFds;
         struct timeval wait;
+        int maxFd;
+#endif
+
+        pfds = fghGetEventFds( &numFds, &wakeupIndex, &numJoysticks, "glutMainLoopEvent()" );
 
-        socket = ConnectionNumber( fgDisplay.pDisplay.Display );
-        FD_ZERO( &fdset );
-        FD_SET( socket, &fdset );
-        wait.tv_sec = msec / 1000;
-        wait.tv_usec = (msec % 1000) * 1000;
-        err = select( socket+1, &fdset, NULL, NULL, &wait );
+#ifdef HAVE_PPOLL
+        wait.tv_sec = usec / 1000000;
+        wait.tv_nsec = (long)(usec % 1000000) * 1000;
+        err = ppoll( pfds, numFds, &wait, NULL );
+
+        if( ( -1 == err ) && ( errno != EINTR ) )
+            fgWarning ( "freeglut ppoll() error: %d", errno );
+#else
+        FD_ZERO( &readFds );
+        FD_ZERO( &writeFds );
+        maxFd = 0;
+        for( i = 0; i < numFds; i++ )
+        {
+            if( pfds[ i ].events & POLLIN )
+                FD_SET( pfds[ i ].fd, &readFds );
+            if( pfds[ i ].events & POLLOUT )
+                FD_SET( pfds[ i ].fd, &writeFds );
+            if( pfds[ i ].fd > maxFd )
+                maxFd = pfds[ i ].fd;
+        }
+        wait.tv_sec = usec / 1000000;
+        wait.tv_usec = usec % 1000000;
+        err = select( maxFd+1, &readFds, &writeFds, NULL, &wait );
 
         if( ( -1 == err ) && ( errno != EINTR ) )
             fgWarning ( "freeglut select() error: %d", errno );
+
+        for( i = 0; err > 0 && i < numFds; i++ )
+            pfds[ i ].revents = ( FD_ISSET( pfds[ i ].fd, &readFds )  ? POLLIN  : 0 ) |
+                                ( FD_ISSET( pfds[ i ].fd, &writeFds ) ? POLLOUT : 0 );
+#endif
+
+        if( err > 0 && wakeupIndex != -1 && pfds[ wakeupIndex ].revents )
+            wokenUp = GL_TRUE;
+        for( i = 1; err > 0 && i <= numJoysticks; i++ )
+            if( pfds[ i ].revents )
+                joystickReady = GL_TRUE;
+
+        if( wokenUp )
+            fgPlatformWakeupDrain( );
+        if( joystickReady )
+            fgPlatformJoystickDrain( );
     }
 }
 
@@ -597,9 +734,8 @@ void fgPlatformProcessSingleEvent ( void )
 
     FREEGLUT_EXIT_IF_NOT_INITIALISED ( "glutMainLoopEvent" );
 
-    while( XPending( fgDisplay.pDisplay.Display ) )
+    while( fghNextEvent( &event ) )
     {
-        XNextEvent( fgDisplay.pDisplay.Display, &event );
 #if _DEBUG
         fghPrintEvent( &event );
 #endif
@@ -656,6 +792,7 @@ void fgPlatformProcessSingleEvent ( void )
                     height = event.xconfigure.height;
                     x = event.xconfigure.x;
                     y = event.xconfigure.y;
+                    fghUpdateGeometryCache( window, &event.xconfigure );
                 }
 
                 /* Update state and call callback, if there was a change */
@@ -687,7 +824,7 @@ void fgPlatformProcessSingleEvent ( void )
             if( event.xexpose.count == 0 )
             {
                 GETWINDOW( xexpose );
-                window->State.WorkMask |= GLUT_DISPLAY_WORK;
+                fgAddToWindowWorkList( window, GLUT_DISPLAY_WORK );
             }
             break;
 
@@ -889,20 +1026,9 @@ void fgPlatformProcessSingleEvent ( void )
                 if (event.type==KeyRelease)
                 {
                     /*
-                     * Look at X11 keystate to detect repeat mode.
-                     * While X11 says the key is actually held down, we'll ignore KeyRelease/KeyPress pairs.
+                     * While the key is auto repeated, we'll ignore the KeyRelease/KeyPress pairs.
                      */
-
-                    char keys[32];
-                    XQueryKeymap( fgDisplay.pDisplay.Display, keys ); /* Look at X11 keystate to detect repeat mode */
-
-                    if ( event.xkey.keycode<256 )            /* XQueryKeymap is limited to 256 keycodes    */
-                    {
-                        if ( keys[event.xkey.keycode>>3] & (1<<(event.xkey.keycode%8)) )
-                            window->State.pWState.KeyRepeating = GL_TRUE;
-                        else
-                            window->State.pWState.KeyRepeating = GL_FALSE;
-                    }
+                    window->State.pWState.KeyRepeating = fghIsKeyRepeat( &event.xkey );
                 }
             }
             else
@@ -1031,7 +1157,28 @@ void fgPlatformProcessSingleEvent ( void )
         break;
 
         case ReparentNotify:
-            break; /* XXX Should disable this event */
+            /*
+             * A window manager framing (or unframing) a top-level window
+             * moves it into another coordinate system; child windows are
+             * only ever reparented by us, at creation.
+             */
+            GETWINDOW( xreparent );
+            if( ! window->Parent )
+            {
+                window->State.pWState.Reparented =
+                    event.xreparent.parent != fgDisplay.pDisplay.RootWindow;
+                window->State.pWState.PositionValid = GL_FALSE;
+                window->State.pWState.FrameValid    = GL_FALSE;
+            }
+            break;
+
+        case PropertyNotify:
+            if( event.xproperty.atom == fgDisplay.pDisplay.NetFrameExtents )
+            {
+                GETWINDOW( xproperty );
+                window->State.pWState.FrameValid = GL_FALSE;
+            }
+            break;
 
         /* Not handled */
         case GravityNotify:
@@ -1053,6 +1200,190 @@ static Bool match_motion(Display *dpy, XEvent *xev, XPointer arg)
     return xev->type == MotionNotify;
 }
 
+/*
+ * With GLUT_COALESCE_EVENTS set, all the events the server has sent are
+ * read at once. Then, going backwards from the latest event, the motion,
+ * configure and expose events that a later event of the same kind for the
+ * same window makes moot are dropped, so that storms of them, e.g. while
+ * a window is being resized, only take one callback per window.
+ */
+#define FGH_MAX_COALESCED_KINDS 32
+
+static void fghCoalesceEventBatch( void )
+{
+    struct { int type; Window window; unsigned int state; } seen[ FGH_MAX_COALESCED_KINDS ];
+    int numSeen = 0, used = 0, i, j;
+
+    for( i = eventBatchUsed - 1; i >= 0; i-- )
+    {
+        XEvent *event = &eventBatch[ i ];
+        Window window;
+        unsigned int state = 0;
+
+        switch( event->type )
+        {
+        case MotionNotify:
+            /* Motion with other buttons held calls the other callback */
+            window = event->xmotion.window;
+            state = event->xmotion.state &
+                    ( Button1Mask | Button2Mask | Button3Mask | Button4Mask | Button5Mask );
+            break;
+
+        case ConfigureNotify:
+            window = event->xconfigure.window;
+            break;
+
+        case Expose:
+            /* Only the last expose of a series is acted upon anyway */
+            if( event->xexpose.count )
+            {
+                event->type = 0;
+                continue;
+            }
+            window = event->xexpose.window;
+            break;
+
+        default:
+            continue;
+        }
+
+        for( j = 0; j < numSeen; j++ )
+            if( seen[ j ].type == event->type && seen[ j ].window == window &&
+                seen[ j ].state == state )
+                break;
+
+        if( j < numSeen )
+            event->type = 0;    /* No X event has type 0 */
+        else if( numSeen < FGH_MAX_COALESCED_KINDS )
+        {
+            seen[ numSeen ].type = event->type;
+            seen[ numSeen ].window = window;
+            seen[ numSeen ].state = state;
+            numSeen++;
+        }
+    }
+
+    for( i = 0; i < eventBatchUsed; i++ )
+        if( eventBatch[ i ].type )
+            eventBatch[ used++ ] = eventBatch[ i ];
+    eventBatchUsed = used;
+}
+
+static void fghReadEventBatch( void )
+{
+    Display *display = fgDisplay.pDisplay.Display;
+
+    eventBatchUsed = eventBatchNext = 0;
+
+    while( XPending( display ) )
+    {
+        if( eventBatchUsed == eventBatchSize )
+        {
+            int size = eventBatchSize ? 2 * eventBatchSize : 64;
+            XEvent *batch = realloc( eventBatch, size * sizeof( XEvent ) );
+            if( !batch )
+                fgError( "Failed to allocate memory in fghReadEventBatch" );
+            eventBatch = batch;
+            eventBatchSize = size;
+        }
+
+        XNextEvent( display, &eventBatch[ eventBatchUsed++ ] );
+
+        /* The data of XInput 2 events is lost once the next event is read */
+        if( eventBatch[ eventBatchUsed - 1 ].type == GenericEvent )
+            break;
+    }
+
+    fghCoalesceEventBatch( );
+}
+
+static GLboolean fghNextEvent( XEvent *event )
+{
+    if( eventBatchNext == eventBatchUsed )
+    {
+        if( !fgState.CoalesceEvents )
+        {
+            if( !XPending( fgDisplay.pDisplay.Display ) )
+                return GL_FALSE;
+            XNextEvent( fgDisplay.pDisplay.Display, event );
+            return GL_TRUE;
+        }
+
+        fghReadEventBatch( );
+        if( !eventBatchUsed )
+            return GL_FALSE;
+    }
+
+    *event = eventBatch[ eventBatchNext++ ];
+    return GL_TRUE;
+}
+
+void fgPlatformDiscardEventBatch( void )
+{
+    free( eventBatch );
+    eventBatch = NULL;
+    eventBatchSize = eventBatchUsed = eventBatchNext = 0;
+}
+
+/*
+ * Finds the event following a KeyRelease, without waiting for the server,
+ * for fgPlatformIsKeyRepeat()
+ */
+static GLboolean fghIsKeyRepeat( const XKeyEvent *release )
+{
+    XEvent next;
+
+    if( eventBatchNext < eventBatchUsed )
+        next = eventBatch[ eventBatchNext ];
+    /* Reads what the server has sent already, but never waits for more */
+    else if( XEventsQueued( release->display, QueuedAfterReading ) )
+        XPeekEvent( release->display, &next );
+    else
+        return fgPlatformIsKeyRepeat( release, NULL );
+
+    return fgPlatformIsKeyRepeat( release, &next );
+}
+
+/*
+ * Keep the answers to glutGet( GLUT_WINDOW_X/Y/WIDTH/HEIGHT ) current so
+ * that fgPlatformGlutGet() need not ask the server. The size is always
+ * that of the event. The position is relative to the window's parent: for
+ * child windows and top-level windows without a window manager frame that
+ * is what glutGet reports. Window managers move a framed window by moving
+ * the frame, and the real event then only gives the (unchanged) offset in
+ * the frame; ICCCM 4.1.5 has them send a synthetic ConfigureNotify with
+ * root coordinates instead, which we use. The fake event from
+ * fgPlatformOpenWindow() (serial 0) only carries the requested position.
+ * Events sent before the server saw our last move or resize are stale.
+ */
+static void fghUpdateGeometryCache( SFG_Window *window, const XConfigureEvent *configure )
+{
+    SFG_PlatformWindowState *pWState = &window->State.pWState;
+
+    if( configure->serial < pWState->GeometrySerial )
+        return;
+
+    pWState->Width     = configure->width;
+    pWState->Height    = configure->height;
+    pWState->SizeValid = GL_TRUE;
+
+    if( configure->serial == 0 && ! configure->send_event )
+        return;
+
+    if( window->Parent || configure->send_event || ! pWState->Reparented )
+    {
+        pWState->X = configure->x + configure->border_width;
+        pWState->Y = configure->y + configure->border_width;
+        pWState->PositionValid = GL_TRUE;
+    }
+    else
+        pWState->PositionValid = GL_FALSE;
+
+    /* The frame may have been resized along with the window */
+    if( ! window->Parent && ! configure->send_event )
+        pWState->FrameValid = GL_FALSE;
+}
+
 void fgPlatformMainLoopPreliminaryWork ( void )
 {
 }
@@ -100,15 +100,19 @@ int fgIsSpaceballXEvent(const XEvent *xev)
 {
     spnav_event sev;
 
-    if(spnav_win != fgStructure.CurrentWindow) {
-        /* this will also initialize spaceball if needed (first call) */
-        fgSpaceballSetWindow(fgStructure.CurrentWindow);
-    }
-
+    /*
+     * The daemon only sends us events once we have talked to it, which
+     * fgInitialiseSpaceball() does when a spaceball callback is set; don't
+     * start talking to it for any other client message.
+     */
     if(fg_sball_initialized != 1) {
         return 0;
     }
 
+    if(spnav_win != fgStructure.CurrentWindow) {
+        fgSpaceballSetWindow(fgStructure.CurrentWindow);
+    }
+
     return spnav_x11_event(xev, &sev);
 }
 
@@ -201,16 +205,26 @@ struct event_node {
 
 static int spnav_x11_open(Display *display, Window win)
 {
+  static char *atom_names[] = {
+    "MotionEvent", "ButtonPressEvent", "ButtonReleaseEvent", "CommandEvent"
+  };
+  Atom atoms[4];
+
   if(IS_OPEN) {
     return -1;
   }
 
   dpy = display;
 
-  motion_event = XInternAtom(dpy, "MotionEvent", True);
-  button_press_event = XInternAtom(dpy, "ButtonPressEvent", True);
-  button_release_event = XInternAtom(dpy, "ButtonReleaseEvent", True);
-  command_event = XInternAtom(dpy, "CommandEvent", True);
+  /* one round trip for all four */
+  if(!XInternAtoms(dpy, atom_names, 4, True, atoms)) {
+    dpy = 0;
+    return -1;  /* daemon not started */
+  }
+  motion_event = atoms[0];
+  button_press_event = atoms[1];
+  button_release_event = atoms[2];
+  command_event = atoms[3];
 
   if(!motion_event || !button_press_event || !button_release_event || !command_event) {
     dpy = 0;
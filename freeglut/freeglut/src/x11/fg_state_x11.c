@@ -80,16 +80,23 @@ int fgPlatformGlutGet ( GLenum eWhat )
 
     /*
      * Those calls are somewhat similar, as they use XGetWindowAttributes()
-     * function
+     * function. Each is a round trip to the server, so unless
+     * GLUT_AUTHORITATIVE_GEOMETRY is set the answer is taken from the last
+     * events where possible, see fghUpdateGeometryCache() in fg_main_x11.c
      */
     case GLUT_WINDOW_X:
     case GLUT_WINDOW_Y:
     {
         int x, y;
         Window p,w;
+        SFG_PlatformWindowState *pWState;
 
         if( fgStructure.CurrentWindow == NULL )
             return 0;
+        pWState = &fgStructure.CurrentWindow->State.pWState;
+
+        if( pWState->PositionValid && ! fgState.AuthoritativeGeometry )
+            return eWhat == GLUT_WINDOW_X ? pWState->X : pWState->Y;
 
         if (fgStructure.CurrentWindow->Parent)
             /* For child window, we should return relative to upper-left
@@ -105,6 +112,10 @@ int fgPlatformGlutGet ( GLenum eWhat )
             p,
             0, 0, &x, &y, &w);
 
+        pWState->X = x;
+        pWState->Y = y;
+        pWState->PositionValid = GL_TRUE;
+
         switch ( eWhat )
         {
         case GLUT_WINDOW_X: return x;
@@ -115,22 +126,27 @@ int fgPlatformGlutGet ( GLenum eWhat )
     case GLUT_WINDOW_BORDER_WIDTH:
     case GLUT_WINDOW_HEADER_HEIGHT:
     {
-        Atom actual_type, net_extents;
+        Atom actual_type;
         int actual_format;
         unsigned long nitems, bytes_after;
         unsigned char *data = NULL;
         int result, top, left;
+        SFG_PlatformWindowState *pWState;
         
         if (fgStructure.CurrentWindow == NULL || fgStructure.CurrentWindow->Parent)
             /* can't get widths/heights if no current window
              * and child windows don't have borders */
             return 0;
+        pWState = &fgStructure.CurrentWindow->State.pWState;
+
+        /* valid until the frame extents change or the window manager reframes us */
+        if( pWState->FrameValid && ! fgState.AuthoritativeGeometry )
+            return eWhat == GLUT_WINDOW_BORDER_WIDTH ? pWState->FrameLeft : pWState->FrameTop;
         
         /* try to get through _NET_FRAME_EXTENTS */
-        net_extents = XInternAtom(fgDisplay.pDisplay.Display, "_NET_FRAME_EXTENTS", False);
-        
         result = XGetWindowProperty(
-            fgDisplay.pDisplay.Display, fgStructure.CurrentWindow->Window.Handle, net_extents,
+            fgDisplay.pDisplay.Display, fgStructure.CurrentWindow->Window.Handle,
+            fgDisplay.pDisplay.NetFrameExtents,
             0, 4, False, AnyPropertyType, 
             &actual_type, &actual_format, 
             &nitems, &bytes_after, &data);
@@ -171,6 +187,10 @@ int fgPlatformGlutGet ( GLenum eWhat )
         if (result == Success)
             XFree(data);
 
+        pWState->FrameLeft  = left;
+        pWState->FrameTop   = top;
+        pWState->FrameValid = GL_TRUE;
+
         switch ( eWhat )
         {
         case GLUT_WINDOW_BORDER_WIDTH:  return left;
@@ -182,14 +202,24 @@ int fgPlatformGlutGet ( GLenum eWhat )
     case GLUT_WINDOW_HEIGHT:
     {
         XWindowAttributes winAttributes;
+        SFG_PlatformWindowState *pWState;
 
         if( fgStructure.CurrentWindow == NULL )
             return 0;
+        pWState = &fgStructure.CurrentWindow->State.pWState;
+
+        if( pWState->SizeValid && ! fgState.AuthoritativeGeometry )
+            return eWhat == GLUT_WINDOW_WIDTH ? pWState->Width : pWState->Height;
+
         XGetWindowAttributes(
             fgDisplay.pDisplay.Display,
             fgStructure.CurrentWindow->Window.Handle,
             &winAttributes
         );
+        pWState->Width     = winAttributes.width;
+        pWState->Height    = winAttributes.height;
+        pWState->SizeValid = GL_TRUE;
+
         switch ( eWhat )
         {
         case GLUT_WINDOW_WIDTH:            return winAttributes.width ;
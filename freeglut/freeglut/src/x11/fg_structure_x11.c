@@ -43,5 +43,12 @@ void fgPlatformCreateWindow ( SFG_Window *window )
 #endif
 
     window->State.pWState.OldHeight = window->State.pWState.OldWidth = -1;
+
+    /* Nothing known about the geometry until the first ConfigureNotify */
+    window->State.pWState.Reparented    = GL_FALSE;
+    window->State.pWState.PositionValid = GL_FALSE;
+    window->State.pWState.SizeValid     = GL_FALSE;
+    window->State.pWState.FrameValid    = GL_FALSE;
+    window->State.pWState.GeometrySerial = 0;
 }
 
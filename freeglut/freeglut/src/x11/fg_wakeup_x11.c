@@ -0,0 +1,114 @@
+/*
+ * fg_wakeup_x11.c
+ *
+ * Waking the main loop up from other threads. The Wayland port uses this
+ * too, the code only relies on POSIX descriptors.
+ *
+ * Creation date: Fri Oct 16 2026
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * PAWEL W. OLSZTA BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <GL/freeglut.h>
+#include "../fg_internal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_EVENTFD_H
+#    include <sys/eventfd.h>
+#endif
+
+/*
+ * The main loop sleeps in poll() or select() on the display connection,
+ * so other threads wake it up by making fghWakeupFds[ 0 ] readable. That
+ * is an eventfd where there is one, else the read end of a pipe whose
+ * write end is fghWakeupFds[ 1 ]. Both ends are non-blocking: a wake up
+ * when the pipe is full is not needed, and draining must not wait.
+ */
+static int fghWakeupFds[ 2 ] = { -1, -1 };
+
+void fgPlatformInitialiseWakeup( void )
+{
+    int i, flags;
+
+#ifdef HAVE_SYS_EVENTFD_H
+    fghWakeupFds[ 0 ] = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    fghWakeupFds[ 1 ] = fghWakeupFds[ 0 ];
+    if( fghWakeupFds[ 0 ] != -1 )
+        return;
+#endif
+
+    if( pipe( fghWakeupFds ) == -1 )
+    {
+        fgWarning( "can't create the main loop wake up pipe: %d", errno );
+        fghWakeupFds[ 0 ] = fghWakeupFds[ 1 ] = -1;
+        return;
+    }
+
+    for( i = 0; i < 2; i++ )
+    {
+        flags = fcntl( fghWakeupFds[ i ], F_GETFL );
+        fcntl( fghWakeupFds[ i ], F_SETFL, flags | O_NONBLOCK );
+        fcntl( fghWakeupFds[ i ], F_SETFD, FD_CLOEXEC );
+    }
+}
+
+void fgPlatformCloseWakeup( void )
+{
+    if( fghWakeupFds[ 1 ] != fghWakeupFds[ 0 ] )
+        close( fghWakeupFds[ 1 ] );
+    if( fghWakeupFds[ 0 ] != -1 )
+        close( fghWakeupFds[ 0 ] );
+
+    fghWakeupFds[ 0 ] = fghWakeupFds[ 1 ] = -1;
+}
+
+/* The descriptor for the main loop to wait on, -1 if there is none */
+int fgPlatformWakeupFd( void )
+{
+    return fghWakeupFds[ 0 ];
+}
+
+/*
+ * Wakes the main loop up, or has its next sleep return at once. This is
+ * called from other threads, and must not touch any other freeglut state.
+ */
+void fgPlatformWakeMainLoop( void )
+{
+    /* An eventfd takes 8 byte counter increments, a pipe anything */
+    uint64_t one = 1;
+
+    if( fghWakeupFds[ 1 ] == -1 )
+        return;
+
+    /* EAGAIN means the descriptor is readable already, which is all we want */
+    while( write( fghWakeupFds[ 1 ], &one, sizeof( one ) ) == -1 && errno == EINTR )
+        ;
+}
+
+/* Makes the descriptor unreadable again, once the main loop has woken up */
+void fgPlatformWakeupDrain( void )
+{
+    char buffer[ 64 ];
+
+    if( fghWakeupFds[ 0 ] == -1 )
+        return;
+
+    while( read( fghWakeupFds[ 0 ], buffer, sizeof( buffer ) ) > 0 )
+        ;
+}
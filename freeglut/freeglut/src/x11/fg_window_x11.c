@@ -63,7 +63,7 @@ static int fghResizeFullscrToggle(void)
 
     if(glutGet(GLUT_FULL_SCREEN)) {
         /* restore original window size */
-        fgStructure.CurrentWindow->State.WorkMask = GLUT_SIZE_WORK;
+        fgAddToWindowWorkList( fgStructure.CurrentWindow, GLUT_SIZE_WORK );
         fgStructure.CurrentWindow->State.DesiredWidth  = win->State.pWState.OldWidth;
         fgStructure.CurrentWindow->State.DesiredHeight = win->State.pWState.OldHeight;
 
@@ -80,12 +80,15 @@ static int fghResizeFullscrToggle(void)
          * The "x" and "y" members of "attributes" are the window's coordinates
          * relative to its parent, i.e. to the decoration window.
          */
+        win->State.pWState.GeometrySerial = NextRequest(fgDisplay.pDisplay.Display);
         XMoveResizeWindow(fgDisplay.pDisplay.Display,
                 fgStructure.CurrentWindow->Window.Handle,
                 -attributes.x,
                 -attributes.y,
                 fgDisplay.ScreenWidth,
                 fgDisplay.ScreenHeight);
+        win->State.pWState.PositionValid = GL_FALSE;
+        win->State.pWState.SizeValid     = GL_FALSE;
     }
     return 0;
 }
@@ -96,6 +99,7 @@ static int fghEwmhFullscrToggle(void)
     XEvent xev;
     long evmask = SubstructureRedirectMask | SubstructureNotifyMask;
 
+    fgInitialiseNetWM();
     if(!fgDisplay.pDisplay.State || !fgDisplay.pDisplay.StateFullScreen) {
         return -1;
     }
@@ -227,6 +231,8 @@ done_retry:
     FREEGLUT_INTERNAL_ERROR_EXIT( visualInfo != NULL,
                                   "visualInfo could not be retrieved from FBConfig", "fgOpenWindow" );
 
+    fgStartupPhase( "framebuffer config selection" );
+
     /*
      * XXX HINT: the masks should be updated when adding/removing callbacks.
      * XXX       This might speed up message processing. Is that true?
@@ -241,7 +247,8 @@ done_retry:
         StructureNotifyMask | SubstructureNotifyMask | ExposureMask |
         ButtonPressMask | ButtonReleaseMask | KeyPressMask | KeyReleaseMask |
         VisibilityChangeMask | EnterWindowMask | LeaveWindowMask |
-        PointerMotionMask | ButtonMotionMask;
+        PointerMotionMask | ButtonMotionMask |
+        PropertyChangeMask;     /* for _NET_FRAME_EXTENTS, see fg_state_x11.c */
     winAttr.background_pixmap = None;
     winAttr.background_pixel  = 0;
     winAttr.border_pixel      = 0;
@@ -286,6 +293,8 @@ done_retry:
     fakeEvent.xconfigure.height = h;
     XPutBackEvent(fgDisplay.pDisplay.Display, &fakeEvent);
 
+    fgStartupPhase( "window creation" );
+
     /*
      * The GLX context creation, possibly trying the direct context rendering
      *  or else use the current context if the user has so specified
@@ -331,6 +340,8 @@ done_retry:
     }
 #endif
 
+    fgStartupPhase( "context creation" );
+
     sizeHints.flags = 0;
     if ( positionUse )
         sizeHints.flags |= USPosition;
@@ -382,14 +393,16 @@ done_retry:
         hints.decorations = (fgState.DisplayMode & GLUT_CAPTIONLESS) ? MWM_DECOR_BORDER:0;
 
         XChangeProperty(fgDisplay.pDisplay.Display, window->Window.Handle,
-                        XInternAtom( fgDisplay.pDisplay.Display, "_MOTIF_WM_HINTS", False ),
-                        XInternAtom( fgDisplay.pDisplay.Display, "_MOTIF_WM_HINTS", False ), 32,
+                        fgDisplay.pDisplay.MotifWMHints,
+                        fgDisplay.pDisplay.MotifWMHints, 32,
                         PropModeReplace,
                         (unsigned char*) &hints,
                         sizeof(MotifWmHints) / sizeof(long));
     }
 
 
+    fgInitialiseNetWM();
+
     if (fgDisplay.pDisplay.NetWMSupported
         && fgDisplay.pDisplay.NetWMPid != None
         && fgDisplay.pDisplay.ClientMachine != None)
@@ -452,6 +465,8 @@ done_retry:
     /* wait till window visible */
     if( !isSubWindow && !window->IsMenu)
         XPeekIfEvent( fgDisplay.pDisplay.Display, &eventReturnBuffer, &fghWindowIsVisible, (XPointer)(window->Window.Handle) );
+
+    fgStartupPhase( "window mapping" );
 #undef WINDOW_CONFIG
 }
 
@@ -461,8 +476,11 @@ done_retry:
  */
 void fgPlatformReshapeWindow ( SFG_Window *window, int width, int height )
 {
+    window->State.pWState.GeometrySerial = NextRequest( fgDisplay.pDisplay.Display );
     XResizeWindow( fgDisplay.pDisplay.Display, window->Window.Handle,
                    width, height );
+    /* Ask the server until the ConfigureNotify arrives */
+    window->State.pWState.SizeValid = GL_FALSE;
     XFlush( fgDisplay.pDisplay.Display ); /* XXX Shouldn't need this */
 }
 
@@ -475,6 +493,10 @@ void fgPlatformCloseWindow( SFG_Window* window )
 #ifdef EGL_VERSION_1_0
     fghPlatformCloseWindowEGL(window);
 #else
+    /* Unbind the window: a new one may get its XID, which fgPlatformSetWindow would take as bound */
+    if( glXGetCurrentDrawable( ) == window->Window.Handle )
+        glXMakeContextCurrent( fgDisplay.pDisplay.Display, None, None, NULL );
+
     if( window->Window.Context )
         glXDestroyContext( fgDisplay.pDisplay.Display, window->Window.Context );
     window->Window.pContext.FBConfig = NULL;
@@ -570,8 +592,11 @@ void fgPlatformGlutSetIconTitle( const char* title )
  */
 void fgPlatformPositionWindow( SFG_Window *window, int x, int y )
 {
+    window->State.pWState.GeometrySerial = NextRequest( fgDisplay.pDisplay.Display );
     XMoveWindow( fgDisplay.pDisplay.Display, window->Window.Handle,
                  x, y );
+    /* Ask the server until the ConfigureNotify arrives */
+    window->State.pWState.PositionValid = GL_FALSE;
     XFlush( fgDisplay.pDisplay.Display ); /* XXX Shouldn't need this */
 }
 
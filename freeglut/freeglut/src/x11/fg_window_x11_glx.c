@@ -250,9 +250,15 @@ GLXContext fghCreateNewContext( SFG_Window* window )
   return context;
 }
 
+/*
+ * glXMakeContextCurrent may flush the pipeline even when nothing changes,
+ * so only call it when another drawable or context has to be bound.
+ */
 void fgPlatformSetWindow ( SFG_Window *window )
 {
-    if ( window )
+    if ( window &&
+         ( glXGetCurrentContext( ) != window->Window.Context ||
+           glXGetCurrentDrawable( ) != window->Window.Handle ) )
     {
         glXMakeContextCurrent(
             fgDisplay.pDisplay.Display,
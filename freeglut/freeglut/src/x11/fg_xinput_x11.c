@@ -19,8 +19,9 @@
 /* import function from fg_main.c */
 extern int fgPlatformGetModifiers( int state );
 
-/* extension opcode for XInput */
+/* extension opcode for XInput, queried when the first window is created */
 static int xi_opcode = -1;
+static int xi_queried = 0;
 
 /**
  * \brief Sets window up for XI2 events.
@@ -34,8 +35,11 @@ void fgRegisterDevices( Display* dpy, Window* win ) {
 	/*Display* dpy = fgDisplay.pDisplay.Display;
 	Window* win = glutGetXWindow();*/
 
-	/* get XInput extension opcode */
-	if (!XQueryExtension( dpy, "XInputExtension", &xi_opcode, &event, &error )) { xi_opcode = -1; }
+	/* get XInput extension opcode, once: it is a round trip */
+	if (!xi_queried) {
+		if (!XQueryExtension( dpy, "XInputExtension", &xi_opcode, &event, &error )) { xi_opcode = -1; }
+		xi_queried = 1;
+	}
 
 	/* Select for motion events */
 	mask.deviceid = XIAllMasterDevices;